@@ -16,7 +16,10 @@
 #
 # opencensus_test(trace_some_test internal/some_test.cc dep1 dep2...)
 function(opencensus_test NAME SRC)
-  if(BUILD_TESTING AND OpenCensus_BUILD_TESTING)
+  # Tests exercise the instrumentation, so they are not built without it.
+  if(BUILD_TESTING
+     AND OpenCensus_BUILD_TESTING
+     AND NOT OpenCensus_DISABLE_INSTRUMENTATION)
     add_executable(${NAME} ${SRC})
     target_include_directories(${NAME}
       PUBLIC
@@ -44,6 +47,9 @@ endfunction()
 
 # Helper function like bazel's cc_library.  Libraries are namespaced as
 # opencensus_* and public libraries are also aliased as opencensus-cpp::*.
+#
+# With OpenCensus_DISABLE_INSTRUMENTATION, every library and everything that
+# links against one is compiled with OPENCENSUS_DISABLE_INSTRUMENTATION.
 function(opencensus_lib NAME)
   cmake_parse_arguments(ARG "PUBLIC" "" "SRCS;DEPS" ${ARGN})
   if(ARG_SRCS)
@@ -53,6 +59,10 @@ function(opencensus_lib NAME)
       PUBLIC
       "$<BUILD_INTERFACE:${PROJECT_SOURCE_DIR}>"
       $<INSTALL_INTERFACE:${CMAKE_INSTALL_INCLUDEDIR}>)
+    if(OpenCensus_DISABLE_INSTRUMENTATION)
+      target_compile_definitions(${NAME}
+                                 PUBLIC OPENCENSUS_DISABLE_INSTRUMENTATION)
+    endif()
   else()
     add_library(${NAME} INTERFACE)
     target_link_libraries(${NAME} INTERFACE ${ARG_DEPS})
@@ -60,6 +70,10 @@ function(opencensus_lib NAME)
       INTERFACE
       "$<BUILD_INTERFACE:${PROJECT_SOURCE_DIR}>"
       $<INSTALL_INTERFACE:${CMAKE_INSTALL_INCLUDEDIR}>)
+    if(OpenCensus_DISABLE_INSTRUMENTATION)
+      target_compile_definitions(${NAME}
+                                 INTERFACE OPENCENSUS_DISABLE_INSTRUMENTATION)
+    endif()
   endif()
   install(TARGETS ${NAME} EXPORT OpenCensusTargets
     RUNTIME DESTINATION ${CMAKE_INSTALL_BINDIR}
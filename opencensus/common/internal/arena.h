@@ -0,0 +1,169 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_COMMON_INTERNAL_ARENA_H_
+#define OPENCENSUS_COMMON_INTERNAL_ARENA_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+
+namespace opencensus {
+namespace common {
+
+// Arena is a bump allocator: memory is carved sequentially out of blocks that
+// are only freed all at once, by Reset() or the destructor. Blocks start at
+// first_block_size bytes and double in size up to kMaxBlockSize. No block is
+// allocated until the first allocation.
+//
+// Only trivially destructible objects may be placed in an Arena, since no
+// destructors are run. Arena is thread-compatible.
+class Arena final {
+ public:
+  static constexpr size_t kMaxBlockSize = 64 * 1024;
+
+  explicit Arena(size_t first_block_size = 1024)
+      : next_block_size_(std::max<size_t>(first_block_size, 64)) {}
+  ~Arena() { FreeBlocks(nullptr); }
+
+  Arena(Arena&& other) noexcept { *this = std::move(other); }
+  Arena& operator=(Arena&& other) noexcept;
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // Returns size bytes aligned to alignment, which must be a power of two no
+  // larger than alignof(std::max_align_t).
+  void* Allocate(size_t size, size_t alignment);
+
+  // Returns uninitialized storage for n objects of type T.
+  template <typename T>
+  T* AllocateArray(size_t n) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "Arena does not run destructors.");
+    return static_cast<T*>(Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  // Returns a copy of s that lives as long as the Arena's memory.
+  absl::string_view CopyString(absl::string_view s) {
+    if (s.empty()) return absl::string_view();
+    char* copy = static_cast<char*>(Allocate(s.size(), 1));
+    memcpy(copy, s.data(), s.size());
+    return absl::string_view(copy, s.size());
+  }
+
+  // Invalidates everything allocated so far. The most recent (largest) block
+  // is kept for reuse; the others are freed.
+  void Reset();
+
+  // The number of bytes requested since construction or the last Reset().
+  size_t bytes_allocated() const { return bytes_allocated_; }
+
+  // The total size of the blocks currently held.
+  size_t bytes_reserved() const { return bytes_reserved_; }
+
+ private:
+  struct alignas(std::max_align_t) Block {
+    Block* prev;
+    size_t size;
+  };
+
+  void AddBlock(size_t min_size);
+  // Frees every block before 'keep', or all blocks if keep is nullptr.
+  void FreeBlocks(Block* keep);
+
+  Block* head_ = nullptr;
+  char* ptr_ = nullptr;
+  char* end_ = nullptr;
+  size_t next_block_size_ = 0;
+  size_t bytes_allocated_ = 0;
+  size_t bytes_reserved_ = 0;
+};
+
+inline Arena& Arena::operator=(Arena&& other) noexcept {
+  if (this != &other) {
+    FreeBlocks(nullptr);
+    head_ = other.head_;
+    ptr_ = other.ptr_;
+    end_ = other.end_;
+    next_block_size_ = other.next_block_size_;
+    bytes_allocated_ = other.bytes_allocated_;
+    bytes_reserved_ = other.bytes_reserved_;
+    other.head_ = nullptr;
+    other.ptr_ = other.end_ = nullptr;
+    other.bytes_allocated_ = 0;
+    other.bytes_reserved_ = 0;
+  }
+  return *this;
+}
+
+inline void* Arena::Allocate(size_t size, size_t alignment) {
+  uintptr_t p = (reinterpret_cast<uintptr_t>(ptr_) + alignment - 1) &
+                ~static_cast<uintptr_t>(alignment - 1);
+  if (ptr_ == nullptr || p + size > reinterpret_cast<uintptr_t>(end_)) {
+    // Block data is max_align_t aligned, so no padding is needed.
+    AddBlock(size);
+    p = reinterpret_cast<uintptr_t>(ptr_);
+  }
+  ptr_ = reinterpret_cast<char*>(p + size);
+  bytes_allocated_ += size;
+  return reinterpret_cast<void*>(p);
+}
+
+inline void Arena::Reset() {
+  if (head_ == nullptr) return;
+  FreeBlocks(head_);
+  head_->prev = nullptr;
+  ptr_ = reinterpret_cast<char*>(head_ + 1);
+  end_ = ptr_ + head_->size;
+  bytes_allocated_ = 0;
+  bytes_reserved_ = head_->size;
+}
+
+inline void Arena::AddBlock(size_t min_size) {
+  const size_t size = std::max(next_block_size_, min_size);
+  next_block_size_ = std::min(next_block_size_ * 2, size_t{kMaxBlockSize});
+  Block* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+  block->prev = head_;
+  block->size = size;
+  head_ = block;
+  bytes_reserved_ += size;
+  ptr_ = reinterpret_cast<char*>(block + 1);
+  end_ = ptr_ + size;
+}
+
+inline void Arena::FreeBlocks(Block* keep) {
+  Block* block = keep == nullptr ? head_ : keep->prev;
+  while (block != nullptr) {
+    Block* prev = block->prev;
+    ::operator delete(block);
+    block = prev;
+  }
+  if (keep == nullptr) {
+    head_ = nullptr;
+    ptr_ = end_ = nullptr;
+    bytes_reserved_ = 0;
+  }
+}
+
+}  // namespace common
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_COMMON_INTERNAL_ARENA_H_
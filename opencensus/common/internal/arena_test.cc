@@ -0,0 +1,76 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/common/internal/arena.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "gtest/gtest.h"
+
+namespace opencensus {
+namespace common {
+namespace {
+
+TEST(ArenaTest, CopyString) {
+  Arena arena;
+  std::string s = "a string";
+  const absl::string_view copy = arena.CopyString(s);
+  s[0] = 'b';
+  EXPECT_EQ("a string", copy);
+  EXPECT_TRUE(arena.CopyString("").empty());
+  EXPECT_EQ(8, arena.bytes_allocated());
+}
+
+TEST(ArenaTest, Alignment) {
+  Arena arena(64);
+  arena.Allocate(1, 1);
+  for (int i = 0; i < 100; ++i) {
+    const auto p = reinterpret_cast<uintptr_t>(arena.AllocateArray<int64_t>(3));
+    EXPECT_EQ(0, p % alignof(int64_t));
+    arena.Allocate(1, 1);
+  }
+}
+
+TEST(ArenaTest, LargeAllocation) {
+  Arena arena(64);
+  char* p = static_cast<char*>(arena.Allocate(1 << 20, 1));
+  p[(1 << 20) - 1] = 1;
+  EXPECT_EQ(1 << 20, arena.bytes_allocated());
+  EXPECT_EQ(1 << 20, arena.bytes_reserved());
+}
+
+TEST(ArenaTest, ResetAndMove) {
+  Arena arena(64);
+  for (int i = 0; i < 100; ++i) arena.CopyString("0123456789");
+  const size_t reserved = arena.bytes_reserved();
+  arena.Reset();
+  EXPECT_EQ(0, arena.bytes_allocated());
+  EXPECT_LT(arena.bytes_reserved(), reserved);
+  EXPECT_LT(0, arena.bytes_reserved());
+  const absl::string_view s = arena.CopyString("kept");
+
+  Arena moved(std::move(arena));
+  EXPECT_EQ(4, moved.bytes_allocated());
+  EXPECT_EQ("kept", s);
+  EXPECT_EQ(0, arena.bytes_allocated());
+  arena = std::move(moved);
+  EXPECT_EQ("kept", s);
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace opencensus
@@ -0,0 +1,150 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_COMMON_INTERNAL_BOUNDED_QUEUE_H_
+#define OPENCENSUS_COMMON_INTERNAL_BOUNDED_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "absl/base/optimization.h"
+
+namespace opencensus {
+namespace common {
+
+// BoundedQueue is a fixed-capacity, lock-free FIFO queue that any number of
+// threads may push to and pop from concurrently (Dmitry Vyukov's bounded MPMC
+// queue). Push and Pop never block and never allocate: Push fails when the
+// queue is full. T must be default-constructible and movable.
+template <typename T>
+class BoundedQueue final {
+ public:
+  // The capacity is rounded up to a power of two, and is at least 2.
+  explicit BoundedQueue(size_t capacity);
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  // Moves 'value' into the queue and returns true, or returns false (leaving
+  // 'value' untouched) if the queue is full.
+  bool TryPush(T&& value);
+
+  // Moves the oldest element into *value and returns true, or returns false if
+  // the queue is empty.
+  bool TryPop(T* value);
+
+  // Returns the number of elements in the queue. This is approximate while
+  // other threads are pushing or popping.
+  size_t SizeApprox() const;
+
+  size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t RoundUpCapacity(size_t capacity) {
+    size_t rounded = 2;
+    while (rounded < capacity) rounded <<= 1;
+    return rounded;
+  }
+
+  const size_t mask_;
+  const std::unique_ptr<Cell[]> cells_;
+  // Producer and consumer positions are kept on separate cache lines.
+  char pad0_[ABSL_CACHELINE_SIZE];
+  std::atomic<size_t> enqueue_pos_;
+  char pad1_[ABSL_CACHELINE_SIZE];
+  std::atomic<size_t> dequeue_pos_;
+  char pad2_[ABSL_CACHELINE_SIZE];
+};
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(size_t capacity)
+    : mask_(RoundUpCapacity(capacity) - 1),
+      cells_(new Cell[mask_ + 1]),
+      enqueue_pos_(0),
+      dequeue_pos_(0) {
+  for (size_t i = 0; i <= mask_; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename T>
+bool BoundedQueue<T>::TryPush(T&& value) {
+  size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[pos & mask_];
+    const size_t seq = cell->sequence.load(std::memory_order_acquire);
+    const intptr_t diff =
+        static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+    if (diff == 0) {
+      if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;  // Full.
+    } else {
+      pos = enqueue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->value = std::move(value);
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool BoundedQueue<T>::TryPop(T* value) {
+  size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+  Cell* cell;
+  while (true) {
+    cell = &cells_[pos & mask_];
+    const size_t seq = cell->sequence.load(std::memory_order_acquire);
+    const intptr_t diff =
+        static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+    if (diff == 0) {
+      if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return false;  // Empty.
+    } else {
+      pos = dequeue_pos_.load(std::memory_order_relaxed);
+    }
+  }
+  *value = std::move(cell->value);
+  cell->value = T();
+  cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+size_t BoundedQueue<T>::SizeApprox() const {
+  const size_t dequeue = dequeue_pos_.load(std::memory_order_relaxed);
+  const size_t enqueue = enqueue_pos_.load(std::memory_order_relaxed);
+  return enqueue > dequeue ? enqueue - dequeue : 0;
+}
+
+}  // namespace common
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_COMMON_INTERNAL_BOUNDED_QUEUE_H_
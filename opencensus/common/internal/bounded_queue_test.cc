@@ -0,0 +1,93 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/common/internal/bounded_queue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace opencensus {
+namespace common {
+namespace {
+
+TEST(BoundedQueueTest, CapacityIsRoundedUp) {
+  EXPECT_EQ(2, BoundedQueue<int>(0).capacity());
+  EXPECT_EQ(8, BoundedQueue<int>(5).capacity());
+  EXPECT_EQ(8, BoundedQueue<int>(8).capacity());
+}
+
+TEST(BoundedQueueTest, Fifo) {
+  BoundedQueue<int> queue(4);
+  int value;
+  EXPECT_FALSE(queue.TryPop(&value));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.TryPush(int(i)));
+  }
+  EXPECT_FALSE(queue.TryPush(4)) << "Queue is full.";
+  EXPECT_EQ(4, queue.SizeApprox());
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.TryPop(&value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_FALSE(queue.TryPop(&value));
+  EXPECT_EQ(0, queue.SizeApprox());
+}
+
+TEST(BoundedQueueTest, FailedPushLeavesValue) {
+  BoundedQueue<std::unique_ptr<int>> queue(2);
+  EXPECT_TRUE(queue.TryPush(std::unique_ptr<int>(new int(1))));
+  EXPECT_TRUE(queue.TryPush(std::unique_ptr<int>(new int(2))));
+  std::unique_ptr<int> value(new int(3));
+  EXPECT_FALSE(queue.TryPush(std::move(value)));
+  ASSERT_NE(nullptr, value);
+  EXPECT_EQ(3, *value);
+}
+
+TEST(BoundedQueueTest, ConcurrentProducers) {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 10000;
+  BoundedQueue<int> queue(64);
+  std::vector<std::thread> producers;
+  for (int t = 0; t < kThreads; ++t) {
+    producers.emplace_back([&queue, t]() {
+      for (int i = 0; i < kPerThread; ++i) {
+        while (!queue.TryPush(t * kPerThread + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  std::vector<int> last(kThreads, -1);
+  int value;
+  for (int popped = 0; popped < kThreads * kPerThread;) {
+    if (!queue.TryPop(&value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    const int thread = value / kPerThread;
+    // Values from each producer arrive in order.
+    EXPECT_LT(last[thread], value % kPerThread);
+    last[thread] = value % kPerThread;
+    ++popped;
+  }
+  for (auto& t : producers) t.join();
+  EXPECT_FALSE(queue.TryPop(&value));
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace opencensus
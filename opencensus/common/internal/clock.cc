@@ -0,0 +1,56 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/common/internal/clock.h"
+
+#include <cstdint>
+#include <limits>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace opencensus {
+namespace common {
+
+namespace {
+
+constexpr int64_t kUnknownOffset = std::numeric_limits<int64_t>::min();
+
+}  // namespace
+
+std::atomic<Clock::TickSource> Clock::tick_source_(nullptr);
+std::atomic<int64_t> Clock::offset_(0);
+
+absl::Time Clock::ToTime(int64_t ticks) {
+  int64_t offset = offset_.load(std::memory_order_relaxed);
+  if (offset == kUnknownOffset) {
+    const int64_t measured = absl::GetCurrentTimeNanos() - NowTicks();
+    // If another thread got there first, use its measurement so that every
+    // conversion agrees.
+    offset = offset_.compare_exchange_strong(offset, measured,
+                                             std::memory_order_relaxed)
+                 ? measured
+                 : offset;
+  }
+  return absl::FromUnixNanos(ticks + offset);
+}
+
+void Clock::SetTickSource(TickSource source) {
+  tick_source_.store(source, std::memory_order_relaxed);
+  offset_.store(source == nullptr ? 0 : kUnknownOffset,
+                std::memory_order_relaxed);
+}
+
+}  // namespace common
+}  // namespace opencensus
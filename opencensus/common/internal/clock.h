@@ -0,0 +1,72 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_COMMON_INTERNAL_CLOCK_H_
+#define OPENCENSUS_COMMON_INTERNAL_CLOCK_H_
+
+#include <atomic>
+#include <cstdint>
+
+#include "absl/base/optimization.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace opencensus {
+namespace common {
+
+// Clock timestamps events in "ticks" of one nanosecond, which take 8 bytes
+// instead of the 16 of an absl::Time and are converted to wall time only when
+// they are exported. By default ticks come from absl's calibrated cycle-counter
+// clock, which is the cheapest clock available, and count from the Unix epoch.
+// A different source, e.g. a monotonic clock or a fake one in tests, may count
+// from any epoch: its offset from wall time is measured at the first
+// conversion.
+class Clock final {
+ public:
+  using TickSource = int64_t (*)();
+
+  // Returns the current time in ticks.
+  static int64_t NowTicks() {
+    const TickSource source = tick_source_.load(std::memory_order_relaxed);
+    if (ABSL_PREDICT_TRUE(source == nullptr)) {
+      return absl::GetCurrentTimeNanos();
+    }
+    return source();
+  }
+
+  // Converts a tick count read from NowTicks() to wall time.
+  static absl::Time ToTime(int64_t ticks);
+
+  // Returns the duration between two tick counts.
+  static absl::Duration ToDuration(int64_t from, int64_t to) {
+    return absl::Nanoseconds(to - from);
+  }
+
+  // Replaces the source of ticks, e.g. with a fake clock in tests, or nullptr
+  // to restore the default. Ticks read from the previous source must not be
+  // converted afterwards.
+  static void SetTickSource(TickSource source);
+
+ private:
+  // nullptr for the default source, which NowTicks() calls directly.
+  static std::atomic<TickSource> tick_source_;
+  // Wall time in Unix nanoseconds minus ticks: 0 for the default source, or
+  // kUnknownOffset until it is first measured for another one.
+  static std::atomic<int64_t> offset_;
+};
+
+}  // namespace common
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_COMMON_INTERNAL_CLOCK_H_
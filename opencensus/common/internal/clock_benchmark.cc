@@ -0,0 +1,53 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+
+#include "absl/time/clock.h"
+#include "benchmark/benchmark.h"
+#include "opencensus/common/internal/clock.h"
+
+namespace {
+
+void BM_AbslNow(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(absl::Now());
+  }
+}
+BENCHMARK(BM_AbslNow);
+
+void BM_GetCurrentTimeNanos(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(absl::GetCurrentTimeNanos());
+  }
+}
+BENCHMARK(BM_GetCurrentTimeNanos);
+
+void BM_NowTicks(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(::opencensus::common::Clock::NowTicks());
+  }
+}
+BENCHMARK(BM_NowTicks);
+
+void BM_ToTime(benchmark::State& state) {
+  const int64_t ticks = ::opencensus::common::Clock::NowTicks();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(::opencensus::common::Clock::ToTime(ticks));
+  }
+}
+BENCHMARK(BM_ToTime);
+
+}  // namespace
+BENCHMARK_MAIN();
@@ -0,0 +1,74 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/common/internal/clock.h"
+
+#include <cstdint>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+
+namespace opencensus {
+namespace common {
+namespace {
+
+int64_t fake_ticks = 0;
+int64_t FakeTicks() { return fake_ticks; }
+
+TEST(ClockTest, TicksAdvance) {
+  int64_t last = Clock::NowTicks();
+  for (int i = 0; i < 1000; ++i) {
+    const int64_t now = Clock::NowTicks();
+    EXPECT_LE(last, now);
+    last = now;
+  }
+}
+
+TEST(ClockTest, ToTimeIsCloseToWallTime) {
+  const absl::Time before = absl::Now();
+  const absl::Time converted = Clock::ToTime(Clock::NowTicks());
+  const absl::Time after = absl::Now();
+  // Allow for the two clocks being read at slightly different moments.
+  EXPECT_LE(before - absl::Milliseconds(10), converted);
+  EXPECT_GE(after + absl::Milliseconds(10), converted);
+}
+
+TEST(ClockTest, DefaultTicksAreUnixNanoseconds) {
+  EXPECT_EQ(absl::FromUnixNanos(12345), Clock::ToTime(12345));
+}
+
+TEST(ClockTest, ToDuration) {
+  EXPECT_EQ(absl::Microseconds(3), Clock::ToDuration(1000, 4000));
+  const int64_t start = Clock::NowTicks();
+  absl::SleepFor(absl::Milliseconds(5));
+  EXPECT_LE(absl::Milliseconds(5),
+            Clock::ToDuration(start, Clock::NowTicks()));
+}
+
+TEST(ClockTest, FakeTickSource) {
+  fake_ticks = 1000;
+  Clock::SetTickSource(&FakeTicks);
+  EXPECT_EQ(1000, Clock::NowTicks());
+  const absl::Time t0 = Clock::ToTime(1000);
+  fake_ticks = 5000;
+  EXPECT_EQ(5000, Clock::NowTicks());
+  EXPECT_EQ(t0 + absl::Nanoseconds(4000), Clock::ToTime(5000));
+  Clock::SetTickSource(nullptr);
+  EXPECT_NE(5000, Clock::NowTicks());
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace opencensus
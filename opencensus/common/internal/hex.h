@@ -0,0 +1,100 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_COMMON_INTERNAL_HEX_H_
+#define OPENCENSUS_COMMON_INTERNAL_HEX_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+
+namespace opencensus {
+namespace common {
+
+namespace hex_internal {
+
+// Maps each character to its value as a hex digit, with kUppercase set for
+// 'A'-'F', or to kInvalid.
+constexpr uint8_t kUppercase = 0x10;
+constexpr uint8_t kInvalid = 0x80;
+constexpr uint8_t kDigitValues[256] = {
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x01,
+    0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e,
+    0x1f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x0a, 0x0b, 0x0c,
+    0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+};
+
+constexpr char kDigits[] = "0123456789abcdef";
+
+}  // namespace hex_internal
+
+// Decodes hex, which must have an even length, into hex.size() / 2 bytes at
+// out. Returns false if hex contains a character that is not a hex digit, or
+// is an uppercase one and lowercase_only is set, in which case out holds
+// garbage. Validation is folded into decoding: every character is looked up
+// and the lookups are combined without branching, so that the loop has a
+// single exit test.
+inline bool HexToBytes(absl::string_view hex, uint8_t* out,
+                       bool lowercase_only = false) {
+  const uint8_t* in = reinterpret_cast<const uint8_t*>(hex.data());
+  const size_t n = hex.size() / 2;
+  uint8_t flags = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const uint8_t hi = hex_internal::kDigitValues[in[2 * i]];
+    const uint8_t lo = hex_internal::kDigitValues[in[2 * i + 1]];
+    flags |= hi | lo;
+    out[i] = static_cast<uint8_t>((hi << 4) | (lo & 0x0f));
+  }
+  const uint8_t rejected =
+      lowercase_only ? (hex_internal::kInvalid | hex_internal::kUppercase)
+                     : hex_internal::kInvalid;
+  return (flags & rejected) == 0;
+}
+
+// Writes the 2 * n lowercase hex digits of the n bytes at in to out. No
+// terminating NUL is written.
+inline void BytesToHex(const uint8_t* in, size_t n, char* out) {
+  for (size_t i = 0; i < n; ++i) {
+    out[2 * i] = hex_internal::kDigits[in[i] >> 4];
+    out[2 * i + 1] = hex_internal::kDigits[in[i] & 0x0f];
+  }
+}
+
+}  // namespace common
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_COMMON_INTERNAL_HEX_H_
@@ -0,0 +1,80 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/common/internal/hex.h"
+
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace opencensus {
+namespace common {
+namespace {
+
+TEST(HexTest, HexToBytes) {
+  uint8_t out[4];
+  EXPECT_TRUE(HexToBytes("0123abCD", out));
+  EXPECT_EQ(0x01, out[0]);
+  EXPECT_EQ(0x23, out[1]);
+  EXPECT_EQ(0xab, out[2]);
+  EXPECT_EQ(0xcd, out[3]);
+}
+
+TEST(HexTest, HexToBytesEmpty) {
+  uint8_t out[1] = {42};
+  EXPECT_TRUE(HexToBytes("", out));
+  EXPECT_EQ(42, out[0]);
+}
+
+TEST(HexTest, HexToBytesRejectsInvalidDigits) {
+  uint8_t out[2];
+  EXPECT_FALSE(HexToBytes("0g", out));
+  EXPECT_FALSE(HexToBytes("G0", out));
+  EXPECT_FALSE(HexToBytes("-1", out));
+  EXPECT_FALSE(HexToBytes(std::string("0\0", 2), out));
+  EXPECT_FALSE(HexToBytes("\xff\xff", out));
+  EXPECT_FALSE(HexToBytes("00 0", out));
+}
+
+TEST(HexTest, HexToBytesLowercaseOnly) {
+  uint8_t out[1];
+  EXPECT_TRUE(HexToBytes("ab", out, /*lowercase_only=*/true));
+  EXPECT_EQ(0xab, out[0]);
+  EXPECT_FALSE(HexToBytes("aB", out, /*lowercase_only=*/true));
+  EXPECT_FALSE(HexToBytes("Ab", out, /*lowercase_only=*/true));
+}
+
+TEST(HexTest, EveryByteRoundTrips) {
+  for (int i = 0; i < 256; ++i) {
+    const uint8_t byte = static_cast<uint8_t>(i);
+    char hex[2];
+    BytesToHex(&byte, 1, hex);
+    uint8_t decoded;
+    ASSERT_TRUE(HexToBytes(absl::string_view(hex, 2), &decoded,
+                           /*lowercase_only=*/true));
+    EXPECT_EQ(byte, decoded);
+  }
+}
+
+TEST(HexTest, BytesToHex) {
+  const uint8_t bytes[] = {0x00, 0x9f, 0xa0, 0xff};
+  char out[9] = "xxxxxxxx";
+  BytesToHex(bytes, 3, out);
+  EXPECT_EQ("009fa0xx", std::string(out));
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace opencensus
@@ -14,16 +14,67 @@
 
 #include "opencensus/common/internal/random.h"
 
+#include <atomic>
 #include <cstring>
+#include <random>
 
-#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
 
 namespace opencensus {
 namespace common {
+namespace {
+
+// SplitMix64, used to expand a seed into Generator state.
+uint64_t SplitMix64(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  return z ^ (z >> 31);
+}
+
+// The MurmurHash3 finalizer, a bijection used to spread Generator numbers.
+uint64_t Mix64(uint64_t x) {
+  x = (x ^ (x >> 33)) * 0xff51afd7ed558ccd;
+  x = (x ^ (x >> 33)) * 0xc4ceb9fe1a85ec53;
+  return x ^ (x >> 33);
+}
+
+uint64_t ProcessSeed() {
+  static const uint64_t seed = [] {
+    std::random_device rd;
+    return ((static_cast<uint64_t>(rd()) << 32) ^ rd()) ^
+           static_cast<uint64_t>(absl::GetCurrentTimeNanos());
+  }();
+  return seed;
+}
+
+std::atomic<uint64_t> g_generator_count(0);
+
+inline uint64_t Rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+}  // namespace
+
+Generator::Generator()
+    : Generator(ProcessSeed() ^
+                Mix64(1 + g_generator_count.fetch_add(
+                              1, std::memory_order_relaxed))) {}
+
+Generator::Generator(uint64_t seed) {
+  for (uint64_t& s : s_) {
+    s = SplitMix64(&seed);
+  }
+}
 
 uint64_t Generator::Random64() {
-  absl::MutexLock l(&mu_);
-  return rng_();
+  const uint64_t result = Rotl(s_[0] + s_[3], 23) + s_[0];
+  const uint64_t t = s_[1] << 17;
+  s_[2] ^= s_[0];
+  s_[3] ^= s_[1];
+  s_[1] ^= s_[2];
+  s_[0] ^= s_[3];
+  s_[2] ^= t;
+  s_[3] = Rotl(s_[3], 45);
+  return result;
 }
 
 Random* Random::GetRandom() {
@@ -31,22 +82,30 @@ Random* Random::GetRandom() {
   return global_random;
 }
 
-uint32_t Random::GenerateRandom32() { return gen_.Random64(); }
+// static
+Generator* Random::ThreadGenerator() {
+  static thread_local Generator generator;
+  return &generator;
+}
+
+uint32_t Random::GenerateRandom32() { return ThreadGenerator()->Random64(); }
 
-uint64_t Random::GenerateRandom64() { return gen_.Random64(); }
+uint64_t Random::GenerateRandom64() { return ThreadGenerator()->Random64(); }
 
 float Random::GenerateRandomFloat() {
-  return static_cast<float>(gen_.Random64()) / static_cast<float>(UINT64_MAX);
+  return static_cast<float>(ThreadGenerator()->Random64()) /
+         static_cast<float>(UINT64_MAX);
 }
 
 double Random::GenerateRandomDouble() {
-  return static_cast<double>(gen_.Random64()) / static_cast<double>(UINT64_MAX);
+  return static_cast<double>(ThreadGenerator()->Random64()) /
+         static_cast<double>(UINT64_MAX);
 }
 
 void Random::GenerateRandomBuffer(uint8_t* buf, size_t buf_size) {
-  absl::MutexLock l(&gen_.mu_);
+  Generator* gen = ThreadGenerator();
   for (size_t i = 0; i < buf_size; i += sizeof(uint64_t)) {
-    uint64_t value = gen_.rng_();
+    uint64_t value = gen->Random64();
     if (i + sizeof(uint64_t) <= buf_size) {
       memcpy(&buf[i], &value, sizeof(uint64_t));
     } else {
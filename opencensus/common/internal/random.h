@@ -17,29 +17,28 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <random>
-
-#include "absl/base/thread_annotations.h"
-#include "absl/synchronization/mutex.h"
-#include "absl/time/clock.h"
 
 namespace opencensus {
 namespace common {
 
+// Generator is a xoshiro256++ pseudo-random number generator
+// (https://prng.di.unimi.it/). It is small and fast, but not thread-safe and
+// not suitable for cryptographic use.
 class Generator {
  public:
-  Generator() : rng_(absl::GetCurrentTimeNanos()) {}
-  explicit Generator(uint64_t seed) : rng_(seed) {}
+  // Seeds the generator from a process-wide source, so that Generators created
+  // in the same process produce different streams.
+  Generator();
+  explicit Generator(uint64_t seed);
 
-  uint64_t Random64() ABSL_LOCKS_EXCLUDED(mu_);
+  uint64_t Random64();
 
  private:
-  friend class Random;
-
-  absl::Mutex mu_;
-  std::mt19937_64 rng_ ABSL_GUARDED_BY(mu_);
+  uint64_t s_[4];
 };
 
+// Random is thread-safe. Each thread draws from its own Generator, so threads
+// do not contend with each other.
 class Random {
  public:
   // Initializes and returns a singleton Random generator.
@@ -67,8 +66,8 @@ class Random {
   Random& operator=(const Random&) = delete;
   Random& operator=(Random&&) = delete;
 
-  uint64_t GenerateValue();
-  Generator gen_;
+  // Returns the calling thread's Generator.
+  static Generator* ThreadGenerator();
 };
 
 }  // namespace common
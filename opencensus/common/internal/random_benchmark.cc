@@ -33,7 +33,7 @@ void BM_Random64(benchmark::State& state) {
     ::opencensus::common::Random::GetRandom()->GenerateRandom64();
   }
 }
-BENCHMARK(BM_Random64);
+BENCHMARK(BM_Random64)->ThreadRange(1, 16);
 
 void BM_RandomBuffer(benchmark::State& state) {
   const size_t size = state.range(0);
@@ -45,5 +45,16 @@ void BM_RandomBuffer(benchmark::State& state) {
 }
 BENCHMARK(BM_RandomBuffer)->Range(1, 16);
 
+// The buffer sizes of a SpanId and a TraceId, from many threads at once.
+void BM_RandomBufferThreaded(benchmark::State& state) {
+  const size_t size = state.range(0);
+  std::vector<uint8_t> buffer(size);
+  for (auto _ : state) {
+    ::opencensus::common::Random::GetRandom()->GenerateRandomBuffer(
+        buffer.data(), size);
+  }
+}
+BENCHMARK(BM_RandomBufferThreaded)->Arg(8)->Arg(16)->ThreadRange(1, 16);
+
 }  // namespace
 BENCHMARK_MAIN();
@@ -13,6 +13,10 @@
 // limitations under the License.
 
 #include "opencensus/common/internal/random.h"
+
+#include <cstdint>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 namespace opencensus {
@@ -33,5 +37,32 @@ TEST(RandomTest, GenerateValues) {
   }
 }
 
+TEST(RandomTest, SeededGeneratorIsDeterministic) {
+  Generator g1(1234);
+  Generator g2(1234);
+  Generator g3(1235);
+  for (int i = 0; i < 100; ++i) {
+    const uint64_t value = g1.Random64();
+    EXPECT_EQ(value, g2.Random64());
+    EXPECT_NE(value, g3.Random64());
+  }
+}
+
+TEST(RandomTest, ThreadsUseDifferentStreams) {
+  uint64_t values[2][8];
+  auto fill = [](uint64_t* out) {
+    for (int i = 0; i < 8; ++i) {
+      out[i] = Random::GetRandom()->GenerateRandom64();
+    }
+  };
+  std::thread t1(fill, values[0]);
+  std::thread t2(fill, values[1]);
+  t1.join();
+  t2.join();
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_NE(values[0][i], values[1][i]);
+  }
+}
+
 }  // namespace common
 }  // namespace opencensus
@@ -15,9 +15,12 @@
 #ifndef OPENCENSUS_CONTEXT_CONTEXT_H_
 #define OPENCENSUS_CONTEXT_CONTEXT_H_
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <string>
 
+#include "absl/base/optimization.h"
 #include "opencensus/tags/tag_map.h"
 #include "opencensus/trace/span.h"
 
@@ -33,8 +36,9 @@ class WithSpan;
 namespace context {
 
 // Context holds information specific to an operation, such as a TagMap and
-// Span. Each thread has a currently active Context. Contexts are conceptually
-// immutable: the contents of a Context cannot be modified in-place.
+// Span. Each thread has a currently active Context. Contexts are immutable: the
+// contents of a Context cannot be modified in-place. A Context is a pointer to
+// shared, reference-counted contents, so copying one is cheap.
 //
 // This is a draft implementation of Context, and we chose to depend on TagMap
 // and Span directly. In future, the implementation will change, so only rely
@@ -45,12 +49,24 @@ class Context {
   // Returns a const reference to the current (thread local) Context.
   static const Context& Current();
 
-  // Context is copiable and movable.
+  // Context is copiable and movable. Copies share their contents.
   Context(const Context&) = default;
   Context(Context&&) = default;
   Context& operator=(const Context&) = default;
   Context& operator=(Context&&) = default;
 
+  // Returns a pointer to the storage for the current Context of the caller.
+  using StorageFunction = Context* (*)();
+
+  // Registers a function that returns the storage for the current Context,
+  // replacing the default thread-local storage. This is for runtimes that run
+  // many logical threads on few OS threads, such as fiber schedulers: each
+  // fiber keeps its own Context, e.g. a copy of Context::Current() taken when
+  // the fiber was created, and the function returns the running fiber's. The
+  // function must be fast and must not use Context. Pass nullptr to restore
+  // the default. Call this before any threads use Context.
+  static void SetStorage(StorageFunction fn);
+
   // Returns an std::function wrapped to run with a copy of this Context.
   std::function<void()> Wrap(std::function<void()> fn) const;
 
@@ -59,24 +75,49 @@ class Context {
   std::string DebugString() const;
 
  private:
+  // The immutable contents of a Context, shared between copies.
+  struct Node;
+
   // Creates a default Context.
-  Context();
+  constexpr Context() noexcept {}
+  explicit Context(std::shared_ptr<const Node> node);
 
   static Context* InternalMutableCurrent();
+
+  const opencensus::tags::TagMap& tags() const;
+  const opencensus::trace::Span& span() const;
+
+  // Return a Context that shares the contents of this one, except for the
+  // TagMap or the Span respectively.
+  Context WithReplacedTags(opencensus::tags::TagMap tags) const;
+  Context WithReplacedSpan(const opencensus::trace::Span& span) const;
   friend void swap(Context& a, Context& b);
 
+  friend class ContextPromise;
   friend class ContextTestPeer;
   friend class WithContext;
-  friend class ContextWrapper;
   friend class ::opencensus::tags::ContextPeer;
   friend class ::opencensus::tags::WithTagMap;
   friend class ::opencensus::trace::ContextPeer;
   friend class ::opencensus::trace::WithSpan;
 
-  opencensus::tags::TagMap tags_;
-  opencensus::trace::Span span_;
+  // nullptr for the default Context, which has no tags and a blank Span.
+  std::shared_ptr<const Node> node_;
+
+  static std::atomic<StorageFunction> storage_;
+  static thread_local Context thread_current_;
 };
 
+// Inline so that, without a registered StorageFunction, looking up the current
+// Context costs a relaxed load and a thread-local access.
+inline Context* Context::InternalMutableCurrent() {
+  const StorageFunction fn = storage_.load(std::memory_order_relaxed);
+  if (ABSL_PREDICT_TRUE(fn == nullptr)) return &thread_current_;
+  return fn();
+}
+
+inline const Context& Context::Current() { return *InternalMutableCurrent(); }
+
 }  // namespace context
 }  // namespace opencensus
 
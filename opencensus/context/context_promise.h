@@ -0,0 +1,207 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_CONTEXT_CONTEXT_PROMISE_H_
+#define OPENCENSUS_CONTEXT_CONTEXT_PROMISE_H_
+
+// Requires C++20 coroutines. Including this header from an earlier language
+// mode is harmless and defines nothing.
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define OPENCENSUS_CONTEXT_HAVE_COROUTINES 1
+#endif
+#endif
+
+#ifdef OPENCENSUS_CONTEXT_HAVE_COROUTINES
+
+#include <coroutine>
+#include <type_traits>
+#include <utility>
+
+#include "opencensus/context/context.h"
+
+namespace opencensus {
+namespace context {
+
+namespace internal {
+
+// Returns the awaiter for 'awaitable', as co_await would.
+template <typename Awaitable>
+decltype(auto) GetAwaiter(Awaitable&& awaitable) {
+  if constexpr (requires {
+                  std::forward<Awaitable>(awaitable).operator co_await();
+                }) {
+    return std::forward<Awaitable>(awaitable).operator co_await();
+  } else if constexpr (requires {
+                         operator co_await(std::forward<Awaitable>(awaitable));
+                       }) {
+    return operator co_await(std::forward<Awaitable>(awaitable));
+  } else {
+    return std::forward<Awaitable>(awaitable);
+  }
+}
+
+// The type used to hold the awaiter for 'Awaitable': a reference for lvalues,
+// which outlive the co_await expression, otherwise a value, since e.g. the
+// result of initial_suspend() does not.
+template <typename Awaitable>
+using AwaiterStorage = std::conditional_t<
+    std::is_lvalue_reference_v<decltype(GetAwaiter(
+        std::declval<Awaitable>()))>,
+    decltype(GetAwaiter(std::declval<Awaitable>())),
+    std::remove_reference_t<decltype(GetAwaiter(std::declval<Awaitable>()))>>;
+
+}  // namespace internal
+
+// ContextPromise is a mixin for coroutine promise types. A coroutine whose
+// promise derives from it runs under the Context that was current when the
+// coroutine was created, on whichever thread resumes it, like a function
+// wrapped with Context::Wrap(). No allocation is done per suspension: the
+// Context is kept in the promise and swapped in and out of the current
+// Context, as WithContext does, when the coroutine resumes and suspends.
+//
+// Every co_await in the coroutine body goes through await_transform() below.
+// The promise type must also pass its initial and final awaiters through
+// WrapInitialSuspend() and WrapFinalSuspend(), and, if it supports co_yield,
+// return WrapYield(awaiter) from yield_value(). If it defines its own
+// await_transform(), that must return WrapSuspend(awaiter).
+//
+// As with WithContext, do not keep a WithSpan, WithTagMap or WithContext
+// alive across a co_await: the coroutine may resume on a different thread.
+//
+// Example usage:
+//   struct Task {
+//     struct promise_type : opencensus::context::ContextPromise {
+//       Task get_return_object() { ... }
+//       auto initial_suspend() {
+//         return WrapInitialSuspend(std::suspend_always{});
+//       }
+//       auto final_suspend() noexcept {
+//         return WrapFinalSuspend(std::suspend_always{});
+//       }
+//       void return_void() {}
+//       void unhandled_exception() { std::terminate(); }
+//     };
+//     ...
+//   };
+class ContextPromise {
+ private:
+  // Swaps the current Context with the one held by the promise. While the
+  // coroutine runs, the promise holds the resuming thread's Context; while it
+  // is suspended, the promise holds the coroutine's.
+  void SwapCurrent() {
+    using std::swap;
+    swap(*Context::InternalMutableCurrent(), context_);
+  }
+
+ public:
+  template <typename Awaitable>
+  class Awaiter {
+   public:
+    Awaiter(ContextPromise* promise, Awaitable&& awaitable)
+        : promise_(promise),
+          awaiter_(internal::GetAwaiter(std::forward<Awaitable>(awaitable))) {}
+
+    bool await_ready() { return awaiter_.await_ready(); }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) {
+      // Restore the resuming thread's Context before handing the coroutine
+      // off: once the inner await_suspend runs, another thread may resume (and
+      // even destroy) it, so *this must not be touched afterwards.
+      promise_->SwapCurrent();
+      suspended_ = true;
+      try {
+        return awaiter_.await_suspend(handle);
+      } catch (...) {
+        suspended_ = false;
+        promise_->SwapCurrent();
+        throw;
+      }
+    }
+
+    decltype(auto) await_resume() {
+      if (suspended_) {
+        promise_->SwapCurrent();
+      }
+      return awaiter_.await_resume();
+    }
+
+   private:
+    ContextPromise* const promise_;
+    bool suspended_ = false;
+    internal::AwaiterStorage<Awaitable> awaiter_;
+  };
+
+  template <typename Awaitable>
+  class FinalAwaiter {
+   public:
+    FinalAwaiter(ContextPromise* promise, Awaitable&& awaitable)
+        : awaiter_(internal::GetAwaiter(std::forward<Awaitable>(awaitable))) {
+      // The coroutine will not run again, so restore the Context of the thread
+      // that ran it last, whether or not it suspends.
+      promise->SwapCurrent();
+    }
+
+    bool await_ready() noexcept { return awaiter_.await_ready(); }
+
+    template <typename Promise>
+    auto await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+      return awaiter_.await_suspend(handle);
+    }
+
+    void await_resume() noexcept { awaiter_.await_resume(); }
+
+   private:
+    internal::AwaiterStorage<Awaitable> awaiter_;
+  };
+
+  // Captures the current Context as the coroutine's.
+  ContextPromise() : context_(Context::Current()) {}
+
+  template <typename Awaitable>
+  Awaiter<Awaitable> await_transform(Awaitable&& awaitable) {
+    return WrapSuspend(std::forward<Awaitable>(awaitable));
+  }
+
+  template <typename Awaitable>
+  Awaiter<Awaitable> WrapSuspend(Awaitable&& awaitable) {
+    return Awaiter<Awaitable>(this, std::forward<Awaitable>(awaitable));
+  }
+
+  template <typename Awaitable>
+  Awaiter<Awaitable> WrapYield(Awaitable&& awaitable) {
+    return Awaiter<Awaitable>(this, std::forward<Awaitable>(awaitable));
+  }
+
+  template <typename Awaitable>
+  Awaiter<Awaitable> WrapInitialSuspend(Awaitable&& awaitable) {
+    return Awaiter<Awaitable>(this, std::forward<Awaitable>(awaitable));
+  }
+
+  template <typename Awaitable>
+  FinalAwaiter<Awaitable> WrapFinalSuspend(Awaitable&& awaitable) noexcept {
+    return FinalAwaiter<Awaitable>(this, std::forward<Awaitable>(awaitable));
+  }
+
+ private:
+  Context context_;
+};
+
+}  // namespace context
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_CONTEXT_HAVE_COROUTINES
+
+#endif  // OPENCENSUS_CONTEXT_CONTEXT_PROMISE_H_
@@ -14,6 +14,7 @@
 
 #include "opencensus/context/context.h"
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <utility>
@@ -26,26 +27,41 @@
 namespace opencensus {
 namespace context {
 
-// Wrapper for per-thread Context, frees the Context on thread shutdown.
-class ContextWrapper {
- public:
-  ContextWrapper() : ptr_(new Context) {}
-  Context* get() { return ptr_.get(); }
+struct Context::Node {
+  Node(std::shared_ptr<const opencensus::tags::TagMap> tags,
+       opencensus::trace::Span span)
+      : tags(std::move(tags)), span(std::move(span)) {}
 
- private:
-  std::unique_ptr<Context> ptr_;
+  // Held by pointer so that Nodes derived by WithReplacedSpan share it instead
+  // of copying it. nullptr if there are no tags.
+  const std::shared_ptr<const opencensus::tags::TagMap> tags;
+  const opencensus::trace::Span span;
 };
 
+std::atomic<Context::StorageFunction> Context::storage_(nullptr);
+thread_local Context Context::thread_current_;
+
 namespace {
-thread_local ContextWrapper g_wrapper;
+// Contents of the default Context. Never destroyed, so that they can be
+// referenced during thread and program shutdown.
+const opencensus::tags::TagMap& EmptyTagMap() {
+  static const auto* const tags = new opencensus::tags::TagMap({});
+  return *tags;
+}
+
+const opencensus::trace::Span& BlankSpan() {
+  static const auto* const span =
+      new opencensus::trace::Span(opencensus::trace::Span::BlankSpan());
+  return *span;
+}
 }  // namespace
 
-Context::Context()
-    : tags_(opencensus::tags::TagMap({})),
-      span_(opencensus::trace::Span::BlankSpan()) {}
+Context::Context(std::shared_ptr<const Node> node) : node_(std::move(node)) {}
 
 // static
-const Context& Context::Current() { return *InternalMutableCurrent(); }
+void Context::SetStorage(StorageFunction fn) {
+  storage_.store(fn, std::memory_order_relaxed);
+}
 
 std::function<void()> Context::Wrap(std::function<void()> fn) const {
   Context copy(Context::Current());
@@ -57,17 +73,34 @@ std::function<void()> Context::Wrap(std::function<void()> fn) const {
 
 std::string Context::DebugString() const {
   return absl::StrCat("ctx@", absl::Hex(this),
-                      " span=", span_.context().ToString(),
-                      ", tags=", tags_.DebugString());
+                      " span=", span().context().ToString(),
+                      ", tags=", tags().DebugString());
 }
 
-// static
-Context* Context::InternalMutableCurrent() { return g_wrapper.get(); }
+const opencensus::tags::TagMap& Context::tags() const {
+  if (node_ == nullptr || node_->tags == nullptr) return EmptyTagMap();
+  return *node_->tags;
+}
+
+const opencensus::trace::Span& Context::span() const {
+  if (node_ == nullptr) return BlankSpan();
+  return node_->span;
+}
+
+Context Context::WithReplacedTags(opencensus::tags::TagMap tags) const {
+  return Context(std::make_shared<const Node>(
+      std::make_shared<const opencensus::tags::TagMap>(std::move(tags)),
+      span()));
+}
+
+Context Context::WithReplacedSpan(const opencensus::trace::Span& span) const {
+  return Context(std::make_shared<const Node>(
+      node_ == nullptr ? nullptr : node_->tags, span));
+}
 
 void swap(Context& a, Context& b) {
   using std::swap;
-  swap(a.span_, b.span_);
-  swap(a.tags_, b.tags_);
+  swap(a.node_, b.node_);
 }
 
 }  // namespace context
@@ -13,9 +13,11 @@
 // limitations under the License.
 
 #include <functional>
+#include <utility>
 
 #include "benchmark/benchmark.h"
 #include "opencensus/context/context.h"
+#include "opencensus/context/with_context.h"
 
 namespace opencensus {
 namespace context {
@@ -29,6 +31,20 @@ void BM_ContextCurrent(benchmark::State& state) {
 }
 BENCHMARK(BM_ContextCurrent);
 
+Context* g_fiber_context;
+Context* FiberContext() { return g_fiber_context; }
+
+void BM_ContextCurrentCustomStorage(benchmark::State& state) {
+  Context fiber_context = Context::Current();
+  g_fiber_context = &fiber_context;
+  Context::SetStorage(FiberContext);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Context::Current());
+  }
+  Context::SetStorage(nullptr);
+}
+BENCHMARK(BM_ContextCurrentCustomStorage);
+
 void BM_CopyDefaultContext(benchmark::State& state) {
   Context ctx = Context::Current();
   for (auto _ : state) {
@@ -47,6 +63,22 @@ void BM_WrapDefaultContext(benchmark::State& state) {
 }
 BENCHMARK(BM_WrapDefaultContext);
 
+void BM_WithContext(benchmark::State& state) {
+  Context ctx = Context::Current();
+  for (auto _ : state) {
+    WithContext wc(ctx);
+  }
+}
+BENCHMARK(BM_WithContext);
+
+void BM_CaptureAndRestoreContext(benchmark::State& state) {
+  for (auto _ : state) {
+    Context ctx = Context::Current();
+    WithContext wc(std::move(ctx));
+  }
+}
+BENCHMARK(BM_CaptureAndRestoreContext);
+
 }  // namespace
 }  // namespace context
 }  // namespace opencensus
@@ -0,0 +1,198 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/context/context_promise.h"
+
+#include "gtest/gtest.h"
+
+#if defined(OPENCENSUS_CONTEXT_REQUIRE_COROUTINES) && \
+    !defined(OPENCENSUS_CONTEXT_HAVE_COROUTINES)
+#error "context_promise_test was built as C++20 but found no coroutines."
+#endif
+
+#ifdef OPENCENSUS_CONTEXT_HAVE_COROUTINES
+
+#include <coroutine>
+#include <exception>
+#include <thread>
+#include <utility>
+
+#include "opencensus/context/context.h"
+#include "opencensus/tags/context_util.h"
+#include "opencensus/tags/tag_key.h"
+#include "opencensus/tags/tag_map.h"
+#include "opencensus/tags/with_tag_map.h"
+
+namespace {
+
+opencensus::tags::TagMap ExampleTagMap() {
+  static const auto k = opencensus::tags::TagKey::Register("key");
+  return opencensus::tags::TagMap({{k, "value"}});
+}
+
+// A lazily started coroutine that is destroyed by its owner.
+class Task {
+ public:
+  struct promise_type : opencensus::context::ContextPromise {
+    Task get_return_object() {
+      return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    auto initial_suspend() { return WrapInitialSuspend(std::suspend_always{}); }
+    auto final_suspend() noexcept {
+      return WrapFinalSuspend(std::suspend_always{});
+    }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+  Task(Task&& other) : handle_(std::exchange(other.handle_, nullptr)) {}
+  ~Task() {
+    if (handle_) handle_.destroy();
+  }
+
+  void Resume() { handle_.resume(); }
+  bool Done() const { return handle_.done(); }
+
+ private:
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// A lazily started coroutine that yields ints.
+class Generator {
+ public:
+  struct promise_type : opencensus::context::ContextPromise {
+    Generator get_return_object() {
+      return Generator(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    auto initial_suspend() { return WrapInitialSuspend(std::suspend_always{}); }
+    auto final_suspend() noexcept {
+      return WrapFinalSuspend(std::suspend_always{});
+    }
+    auto yield_value(int value) {
+      value_ = value;
+      return WrapYield(std::suspend_always{});
+    }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+
+    int value_ = 0;
+  };
+
+  explicit Generator(std::coroutine_handle<promise_type> handle)
+      : handle_(handle) {}
+  Generator(Generator&& other)
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  ~Generator() {
+    if (handle_) handle_.destroy();
+  }
+
+  // Runs until the next co_yield, and returns its value.
+  int Next() {
+    handle_.resume();
+    return handle_.promise().value_;
+  }
+  bool Done() const { return handle_.done(); }
+
+ private:
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// Suspends the coroutine, storing its handle so that the test can resume it.
+struct Suspend {
+  std::coroutine_handle<>* handle;
+
+  bool await_ready() { return false; }
+  void await_suspend(std::coroutine_handle<> h) { *handle = h; }
+  int await_resume() { return 42; }
+};
+
+Task Coroutine(std::coroutine_handle<>* handle, bool* had_tags, int* result) {
+  *result = co_await Suspend{handle};
+  *had_tags = opencensus::tags::GetCurrentTagMap() == ExampleTagMap();
+}
+
+Task ReadyCoroutine(bool* had_tags) {
+  co_await std::suspend_never{};
+  *had_tags = opencensus::tags::GetCurrentTagMap() == ExampleTagMap();
+}
+
+// Yields 1 if it runs with ExampleTagMap(), otherwise 0, twice.
+Generator HadTags() {
+  for (int i = 0; i < 2; ++i) {
+    co_yield opencensus::tags::GetCurrentTagMap() == ExampleTagMap() ? 1 : 0;
+  }
+}
+
+TEST(ContextPromiseTest, ContextIsCarriedAcrossThreads) {
+  std::coroutine_handle<> handle;
+  bool had_tags = false;
+  int result = 0;
+  Task task = [&] {
+    opencensus::tags::WithTagMap wt(ExampleTagMap());
+    return Coroutine(&handle, &had_tags, &result);
+  }();
+
+  // Start on a thread without the tags. The coroutine runs with them until
+  // it suspends, then the thread's own Context is restored.
+  std::thread([&] {
+    task.Resume();
+    EXPECT_TRUE(opencensus::tags::GetCurrentTagMap().tags().empty());
+  }).join();
+  ASSERT_TRUE(handle);
+  EXPECT_FALSE(task.Done());
+
+  // Resume on yet another thread.
+  std::thread([&] {
+    handle.resume();
+    EXPECT_TRUE(opencensus::tags::GetCurrentTagMap().tags().empty());
+  }).join();
+  EXPECT_TRUE(task.Done());
+  EXPECT_TRUE(had_tags);
+  EXPECT_EQ(42, result);
+  EXPECT_TRUE(opencensus::tags::GetCurrentTagMap().tags().empty());
+}
+
+TEST(ContextPromiseTest, AwaitWithoutSuspending) {
+  bool had_tags = false;
+  Task task = [&] {
+    opencensus::tags::WithTagMap wt(ExampleTagMap());
+    return ReadyCoroutine(&had_tags);
+  }();
+  task.Resume();
+  EXPECT_TRUE(task.Done());
+  EXPECT_TRUE(had_tags);
+  EXPECT_TRUE(opencensus::tags::GetCurrentTagMap().tags().empty());
+}
+
+TEST(ContextPromiseTest, YieldRestoresContext) {
+  Generator generator = [] {
+    opencensus::tags::WithTagMap wt(ExampleTagMap());
+    return HadTags();
+  }();
+  for (int i = 0; i < 2; ++i) {
+    std::thread([&] {
+      EXPECT_EQ(1, generator.Next());
+      EXPECT_TRUE(opencensus::tags::GetCurrentTagMap().tags().empty());
+    }).join();
+  }
+  generator.Next();
+  EXPECT_TRUE(generator.Done());
+  EXPECT_TRUE(opencensus::tags::GetCurrentTagMap().tags().empty());
+}
+
+}  // namespace
+
+#endif  // OPENCENSUS_CONTEXT_HAVE_COROUTINES
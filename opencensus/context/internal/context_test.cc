@@ -112,4 +112,49 @@ TEST(ContextTest, WrappedFnIsCopiable) {
   fn2();
 }
 
+TEST(ContextTest, CapturedContextIsUnchangedByLaterScopes) {
+  auto span = opencensus::trace::Span::StartSpan("MySpan");
+  {
+    opencensus::tags::WithTagMap wt(ExampleTagMap());
+    const opencensus::context::Context captured =
+        opencensus::context::Context::Current();
+    {
+      opencensus::trace::WithSpan ws(span);
+      EXPECT_EQ(ExampleTagMap(), opencensus::tags::GetCurrentTagMap())
+          << "Installing a Span keeps the current tags.";
+      EXPECT_EQ(span.context(), opencensus::trace::GetCurrentSpan().context());
+      EXPECT_EQ(opencensus::trace::SpanContext(),
+                opencensus::trace::GetSpanFromContext(captured).context());
+    }
+    EXPECT_EQ(ExampleTagMap(),
+              opencensus::tags::GetTagMapFromContext(captured));
+  }
+  ExpectEmptyContext();
+  span.End();
+}
+
+opencensus::context::Context* g_fiber_context = nullptr;
+
+opencensus::context::Context* FiberContext() { return g_fiber_context; }
+
+TEST(ContextTest, CustomStorage) {
+  // Stands in for the Context slot of a fiber.
+  opencensus::context::Context fiber_context =
+      opencensus::context::Context::Current();
+  g_fiber_context = &fiber_context;
+  opencensus::context::Context::SetStorage(FiberContext);
+  {
+    opencensus::tags::WithTagMap wt(ExampleTagMap());
+    EXPECT_EQ(ExampleTagMap(),
+              opencensus::tags::GetTagMapFromContext(fiber_context));
+    EXPECT_EQ(&fiber_context, &opencensus::context::Context::Current());
+  }
+  EXPECT_TRUE(opencensus::tags::GetTagMapFromContext(fiber_context)
+                  .tags()
+                  .empty());
+  opencensus::context::Context::SetStorage(nullptr);
+  g_fiber_context = nullptr;
+  ExpectEmptyContext();
+}
+
 }  // namespace
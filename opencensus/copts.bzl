@@ -45,3 +45,22 @@ TEST_COPTS = DEFAULT_COPTS + select({
     "//opencensus:windows": ABSL_MSVC_TEST_FLAGS,
     "//conditions:default": ABSL_GCC_TEST_FLAGS + WERROR + WARN_FLAGS,
 })
+
+# Copts for tests of C++20-only headers, such as context/context_promise.h, which
+# are compiled out in earlier language modes. Only the test's own sources are
+# built as C++20.
+CXX20_TEST_COPTS = TEST_COPTS + select({
+    "//opencensus:windows": ["/std:c++20"],
+    "//conditions:default": ["-std=c++20"],
+})
+
+# Defines for the libraries whose public API is compiled to no-ops by
+# --config=disable_instrumentation. Unlike copts, defines propagate to
+# everything that depends on the library, so that the API's headers are seen
+# the same way everywhere.
+INSTRUMENTATION_DEFINES = select({
+    "//opencensus:disable_instrumentation": [
+        "OPENCENSUS_DISABLE_INSTRUMENTATION",
+    ],
+    "//conditions:default": [],
+})
@@ -351,7 +351,7 @@ void OcAgentExporter::Register(OcAgentOptions &&opts) {
         ::opencensus::proto::agent::trace::v1::TraceService::NewStub(channel);
   }
   ::opencensus::trace::exporter::SpanExporter::RegisterHandler(
-      absl::make_unique<Handler>(std::move(opts)));
+      absl::make_unique<Handler>(std::move(opts)), "ocagent");
 }
 
 }  // namespace trace
@@ -263,7 +263,7 @@ void StackdriverExporter::Register(StackdriverOptions&& opts) {
     opts.trace_service_stub = MakeStackdriverStub();
   }
   ::opencensus::trace::exporter::SpanExporter::RegisterHandler(
-      absl::make_unique<Handler>(std::move(opts)));
+      absl::make_unique<Handler>(std::move(opts)), "stackdriver");
 }
 
 // static, DEPRECATED
@@ -277,7 +277,7 @@ void StackdriverExporter::Register(StackdriverOptions& opts) {
   copied_opts.rpc_deadline = opts.rpc_deadline;
   copied_opts.trace_service_stub = std::move(opts.trace_service_stub);
   ::opencensus::trace::exporter::SpanExporter::RegisterHandler(
-      absl::make_unique<Handler>(std::move(copied_opts)));
+      absl::make_unique<Handler>(std::move(copied_opts)), "stackdriver");
 }
 
 // static, DEPRECATED
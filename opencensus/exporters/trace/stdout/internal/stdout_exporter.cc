@@ -48,7 +48,7 @@ class Handler : public ::opencensus::trace::exporter::SpanExporter::Handler {
 // static
 void StdoutExporter::Register(std::ostream* stream) {
   ::opencensus::trace::exporter::SpanExporter::RegisterHandler(
-      absl::make_unique<Handler>(stream));
+      absl::make_unique<Handler>(stream), "stdout");
 }
 
 }  // namespace trace
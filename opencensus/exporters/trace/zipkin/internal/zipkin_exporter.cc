@@ -385,7 +385,8 @@ void ZipkinExporter::Register(const ZipkinExporterOptions& options) {
   handler->service_.ip_address = GetIpAddress(options.af_type);
   ::opencensus::trace::exporter::SpanExporter::RegisterHandler(
       absl::WrapUnique<::opencensus::trace::exporter::SpanExporter::Handler>(
-          handler));
+          handler),
+      "zipkin");
 }
 
 }  // namespace trace
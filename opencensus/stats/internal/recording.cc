@@ -15,8 +15,10 @@
 #include "opencensus/stats/recording.h"
 
 #include <initializer_list>
+#include <utility>
 
 #include "opencensus/stats/internal/delta_producer.h"
+#include "opencensus/stats/internal/stats_manager.h"
 #include "opencensus/stats/measure.h"
 #include "opencensus/tags/context_util.h"
 #include "opencensus/tags/tag_map.h"
@@ -24,15 +26,24 @@
 namespace opencensus {
 namespace stats {
 
+// With OPENCENSUS_DISABLE_INSTRUMENTATION, Record() is implemented inline in
+// recording.h.
+#ifndef OPENCENSUS_DISABLE_INSTRUMENTATION
+
 void Record(std::initializer_list<Measurement> measurements) {
+  // Without views, skip copying the tags and locking the delta.
+  if (!StatsManager::Get()->HasConsumers()) return;
   DeltaProducer::Get()->Record(measurements,
                                opencensus::tags::GetCurrentTagMap());
 }
 
 void Record(std::initializer_list<Measurement> measurements,
             opencensus::tags::TagMap tags) {
+  if (!StatsManager::Get()->HasConsumers()) return;
   DeltaProducer::Get()->Record(measurements, std::move(tags));
 }
 
+#endif  // OPENCENSUS_DISABLE_INSTRUMENTATION
+
 }  // namespace stats
 }  // namespace opencensus
@@ -189,6 +189,7 @@ StatsManager::ViewInformation* StatsManager::AddConsumer(
         index, descriptor.aggregation().bucket_boundaries());
   }
   absl::MutexLock l(&mu_);
+  num_consumers_.fetch_add(1, std::memory_order_relaxed);
   return measures_[index].AddConsumer(descriptor);
 }
 
@@ -196,6 +197,7 @@ void StatsManager::RemoveConsumer(ViewInformation* handle) {
   absl::MutexLock l(&mu_);
   const int num_consumers_remaining = handle->RemoveConsumer();
   ABSL_ASSERT(num_consumers_remaining >= 0);
+  num_consumers_.fetch_sub(1, std::memory_order_relaxed);
   if (num_consumers_remaining == 0) {
     const auto& descriptor = handle->view_descriptor();
     const uint64_t index =
@@ -15,6 +15,7 @@
 #ifndef OPENCENSUS_STATS_INTERNAL_STATS_MANAGER_H_
 #define OPENCENSUS_STATS_INTERNAL_STATS_MANAGER_H_
 
+#include <atomic>
 #include <memory>
 
 #include "absl/synchronization/mutex.h"
@@ -100,6 +101,12 @@ class StatsManager final {
   // that was the last consumer.
   void RemoveConsumer(ViewInformation* handle) ABSL_LOCKS_EXCLUDED(mu_);
 
+  // Returns true if any view has a consumer. If not, recorded data would be
+  // dropped when the delta is merged, so Record() can return right away.
+  bool HasConsumers() const {
+    return num_consumers_.load(std::memory_order_relaxed) > 0;
+  }
+
  private:
   // MeasureInformation stores all ViewInformation objects for a given measure.
   class MeasureInformation {
@@ -128,6 +135,10 @@ class StatsManager final {
 
   // All registered measures.
   std::vector<MeasureInformation> measures_ ABSL_GUARDED_BY(mu_);
+
+  // The number of consumers over all views. Only changed while holding mu_,
+  // but read without it.
+  std::atomic<int> num_consumers_{0};
 };
 
 extern template void StatsManager::AddMeasure(MeasureDouble measure);
@@ -180,6 +180,15 @@ void BM_RecordBatched(benchmark::State& state) {
 }
 BENCHMARK(BM_RecordBatched);
 
+// Benchmarks recording while no view is registered, which should do no work.
+void BM_RecordWithoutViews(benchmark::State& state) {
+  MeasureDouble measure = MeasureDouble::Register(MakeUniqueName(), "", "");
+  for (auto _ : state) {
+    Record({{measure, 1.0}});
+  }
+}
+BENCHMARK(BM_RecordWithoutViews);
+
 // TODO: Other useful benchmarks:
 //  - Multithreaded recording against one/different measures.
 //  - Recording with parameterized numbers of tag keys.
@@ -44,6 +44,13 @@ void Record(std::initializer_list<Measurement> measurements);
 void Record(std::initializer_list<Measurement> measurements,
             opencensus::tags::TagMap tags);
 
+#ifdef OPENCENSUS_DISABLE_INSTRUMENTATION
+// Recording is compiled out, see README.md.
+inline void Record(std::initializer_list<Measurement> /*measurements*/) {}
+inline void Record(std::initializer_list<Measurement> /*measurements*/,
+                   opencensus::tags::TagMap /*tags*/) {}
+#endif  // OPENCENSUS_DISABLE_INSTRUMENTATION
+
 }  // namespace stats
 }  // namespace opencensus
 
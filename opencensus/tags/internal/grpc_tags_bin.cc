@@ -14,9 +14,13 @@
 
 #include "opencensus/tags/propagation/grpc_tags_bin.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/string_view.h"
@@ -36,8 +40,51 @@ constexpr char kVersionId = '\0';
 constexpr char kTagFieldId = '\0';
 constexpr int kMaxLen = 8192;
 
+std::string Encode(const TagMap& tags) {
+  std::string out;
+  out.push_back(kVersionId);
+  for (const auto& key_val : tags.tags()) {
+    const std::string& key = key_val.first.name();
+    const std::string& val = key_val.second;
+    out.push_back(kTagFieldId);
+    AppendVarint32(key.length(), &out);
+    out.append(key);
+    AppendVarint32(val.length(), &out);
+    // Encoded value must be UTF-8.
+    out.append(val);
+    if (out.size() > kMaxLen) {
+      break;
+    }
+  }
+  if (out.size() > kMaxLen) {
+    return "";
+  }
+  return out;
+}
+
 }  // namespace
 
+// Populates and reads TagMap::grpc_tags_bin_.
+class GrpcTagsBinCache {
+ public:
+  static absl::string_view Get(const TagMap& tags) {
+    std::shared_ptr<const std::string> encoded =
+        std::atomic_load(&tags.grpc_tags_bin_);
+    if (encoded == nullptr) {
+      // Once set, the cached value is never replaced, so views into it remain
+      // valid for the lifetime of the map. If another thread wins the race,
+      // use its value and discard ours.
+      std::shared_ptr<const std::string> expected;
+      encoded = std::make_shared<const std::string>(Encode(tags));
+      if (!std::atomic_compare_exchange_strong(&tags.grpc_tags_bin_, &expected,
+                                               encoded)) {
+        encoded = std::move(expected);
+      }
+    }
+    return *encoded;
+  }
+};
+
 bool FromGrpcTagsBinHeader(absl::string_view header, TagMap* out) {
   std::unordered_map<std::string, absl::string_view> keys_vals;
   if (header.length() < 1) {
@@ -103,25 +150,20 @@ bool FromGrpcTagsBinHeader(absl::string_view header, TagMap* out) {
 }
 
 std::string ToGrpcTagsBinHeader(const TagMap& tags) {
-  std::string out;
-  out.push_back(kVersionId);
-  for (const auto& key_val : tags.tags()) {
-    const auto& key = key_val.first;
-    const auto& val = key_val.second;
-    out.push_back(kTagFieldId);
-    AppendVarint32(key.name().length(), &out);
-    out.append(key.name());
-    AppendVarint32(val.length(), &out);
-    // Encoded value must be UTF-8.
-    out.append(val);
-    if (out.size() > kMaxLen) {
-      break;
-    }
-  }
-  if (out.size() > kMaxLen) {
-    return "";
+  return std::string(GrpcTagsBinCache::Get(tags));
+}
+
+absl::string_view ToGrpcTagsBinHeaderView(const TagMap& tags) {
+  return GrpcTagsBinCache::Get(tags);
+}
+
+size_t ToGrpcTagsBinHeader(const TagMap& tags, char* out, size_t out_len) {
+  const absl::string_view encoded = GrpcTagsBinCache::Get(tags);
+  if (encoded.empty() || encoded.size() > out_len) {
+    return 0;
   }
-  return out;
+  memcpy(out, encoded.data(), encoded.size());
+  return encoded.size();
 }
 
 }  // namespace propagation
@@ -46,6 +46,33 @@ void BM_ToGrpcTagsBinHeader(benchmark::State& state) {
 }
 BENCHMARK(BM_ToGrpcTagsBinHeader);
 
+void BM_ToGrpcTagsBinHeaderView(benchmark::State& state) {
+  TagMap m({{TagKey::Register("key"), "val"}});
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ToGrpcTagsBinHeaderView(m));
+  }
+}
+BENCHMARK(BM_ToGrpcTagsBinHeaderView);
+
+void BM_ToGrpcTagsBinHeaderBuffer(benchmark::State& state) {
+  TagMap m({{TagKey::Register("key"), "val"}});
+  char buf[64];
+  for (auto _ : state) {
+    ToGrpcTagsBinHeader(m, buf, sizeof(buf));
+  }
+}
+BENCHMARK(BM_ToGrpcTagsBinHeaderBuffer);
+
+void BM_ToGrpcTagsBinHeaderUncached(benchmark::State& state) {
+  TagMap m({{TagKey::Register("key"), "val"}});
+  for (auto _ : state) {
+    // Copying the map shares its cache; constructing a new one does not.
+    TagMap fresh(m.tags());
+    ToGrpcTagsBinHeader(fresh);
+  }
+}
+BENCHMARK(BM_ToGrpcTagsBinHeaderUncached);
+
 }  // namespace
 }  // namespace propagation
 }  // namespace tags
@@ -161,6 +161,39 @@ TEST(GrpcTagsBinTest, SerializeTooLong) {
   TagMap m(std::move(tags));
   EXPECT_EQ("", ToGrpcTagsBinHeader(m))
       << "Serialization failed due to value being too long.";
+  char buf[16];
+  EXPECT_EQ(0, ToGrpcTagsBinHeader(m, buf, sizeof(buf)));
+}
+
+TEST(GrpcTagsBinTest, SerializeViewIsCached) {
+  static const auto k1 = TagKey::Register("k1");
+  TagMap m({{k1, "v"}});
+  const absl::string_view first = ToGrpcTagsBinHeaderView(m);
+  const absl::string_view second = ToGrpcTagsBinHeaderView(m);
+  EXPECT_EQ(first.data(), second.data());
+  EXPECT_EQ(ToGrpcTagsBinHeader(m), first);
+}
+
+TEST(GrpcTagsBinTest, CopiesShareCachedEncoding) {
+  static const auto k1 = TagKey::Register("k1");
+  TagMap m1({{k1, "v"}});
+  const absl::string_view encoded = ToGrpcTagsBinHeaderView(m1);
+  TagMap m2(m1);
+  EXPECT_EQ(encoded.data(), ToGrpcTagsBinHeaderView(m2).data());
+  TagMap m3({});
+  m3 = m1;
+  EXPECT_EQ(encoded.data(), ToGrpcTagsBinHeaderView(m3).data());
+}
+
+TEST(GrpcTagsBinTest, SerializeToBuffer) {
+  static const auto k1 = TagKey::Register("k1");
+  TagMap m({{k1, "v"}});
+  const std::string expected = ToGrpcTagsBinHeader(m);
+  char buf[64];
+  ASSERT_EQ(expected.size(), ToGrpcTagsBinHeader(m, buf, sizeof(buf)));
+  EXPECT_EQ(expected, absl::string_view(buf, expected.size()));
+  EXPECT_EQ(0, ToGrpcTagsBinHeader(m, buf, expected.size() - 1))
+      << "Buffer too small.";
 }
 
 }  // namespace
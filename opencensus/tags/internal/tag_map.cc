@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cassert>
 #include <initializer_list>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -44,6 +45,20 @@ TagMap::TagMap(std::vector<std::pair<TagKey, std::string>> tags)
   Initialize();
 }
 
+TagMap::TagMap(const TagMap& other)
+    : hash_(other.hash_),
+      tags_(other.tags_),
+      grpc_tags_bin_(std::atomic_load(&other.grpc_tags_bin_)) {}
+
+TagMap& TagMap::operator=(const TagMap& other) {
+  if (this != &other) {
+    hash_ = other.hash_;
+    tags_ = other.tags_;
+    grpc_tags_bin_ = std::atomic_load(&other.grpc_tags_bin_);
+  }
+  return *this;
+}
+
 void TagMap::Initialize() {
   std::sort(tags_.begin(), tags_.end());
 
@@ -26,8 +26,13 @@ using ::opencensus::tags::TagMap;
 namespace opencensus {
 namespace tags {
 
+// With OPENCENSUS_DISABLE_INSTRUMENTATION, WithTagMap is implemented inline in
+// with_tag_map.h.
+#ifndef OPENCENSUS_DISABLE_INSTRUMENTATION
+
 WithTagMap::WithTagMap(const TagMap& tags, bool cond)
-    : swapped_tags_(tags)
+    : swapped_context_(cond ? Context::Current().WithReplacedTags(tags)
+                            : Context())
 #ifndef NDEBUG
       ,
       original_context_(Context::InternalMutableCurrent())
@@ -38,7 +43,9 @@ WithTagMap::WithTagMap(const TagMap& tags, bool cond)
 }
 
 WithTagMap::WithTagMap(TagMap&& tags, bool cond)
-    : swapped_tags_(std::move(tags))
+    : swapped_context_(
+          cond ? Context::Current().WithReplacedTags(std::move(tags))
+               : Context())
 #ifndef NDEBUG
       ,
       original_context_(Context::InternalMutableCurrent())
@@ -60,9 +67,11 @@ WithTagMap::~WithTagMap() {
 void WithTagMap::ConditionalSwap() {
   if (cond_) {
     using std::swap;
-    swap(Context::InternalMutableCurrent()->tags_, swapped_tags_);
+    swap(*Context::InternalMutableCurrent(), swapped_context_);
   }
 }
 
+#endif  // OPENCENSUS_DISABLE_INSTRUMENTATION
+
 }  // namespace tags
 }  // namespace opencensus
@@ -15,6 +15,7 @@
 #ifndef OPENCENSUS_TAGS_PROPAGATION_GRPC_TAGS_BIN_H_
 #define OPENCENSUS_TAGS_PROPAGATION_GRPC_TAGS_BIN_H_
 
+#include <cstddef>
 #include <string>
 
 #include "absl/strings/string_view.h"
@@ -35,6 +36,18 @@ bool FromGrpcTagsBinHeader(absl::string_view header, TagMap* out);
 // serialization failed.
 std::string ToGrpcTagsBinHeader(const TagMap& tags);
 
+// Returns a view of the value for the grpc-tags-bin header, or an empty view if
+// serialization failed. The encoding is computed the first time it is needed
+// and cached in 'tags', where it is shared with copies of 'tags', so repeated
+// propagation of the same TagMap does not re-serialize it. The view remains
+// valid until 'tags' is destroyed or assigned to.
+absl::string_view ToGrpcTagsBinHeaderView(const TagMap& tags);
+
+// Fills a pre-allocated buffer with the value for the grpc-tags-bin header,
+// using the cached encoding as above. Returns the number of bytes written, or 0
+// if serialization failed or the value does not fit in 'out_len' bytes.
+size_t ToGrpcTagsBinHeader(const TagMap& tags, char* out, size_t out_len);
+
 }  // namespace propagation
 }  // namespace tags
 }  // namespace opencensus
@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <initializer_list>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,6 +28,10 @@
 namespace opencensus {
 namespace tags {
 
+namespace propagation {
+class GrpcTagsBinCache;
+}  // namespace propagation
+
 // TagMap represents an immutable map of TagKeys to tag values (strings), and
 // provides efficient equality and hash operations. A TagMap is expensive to
 // construct, and should be shared between uses where possible.
@@ -41,6 +46,13 @@ class TagMap final {
   // TagMaps. It takes the argument by value to allow it to be moved.
   TagMap(std::vector<std::pair<TagKey, std::string>> tags);
 
+  // Copies share the cached wire encoding (see propagation/grpc_tags_bin.h),
+  // if one has been computed.
+  TagMap(const TagMap& other);
+  TagMap(TagMap&& other) = default;
+  TagMap& operator=(const TagMap& other);
+  TagMap& operator=(TagMap&& other) = default;
+
   // Accesses the tags sorted by key (in an implementation-defined, not
   // lexicographic, order).
   const std::vector<std::pair<TagKey, std::string>>& tags() const {
@@ -59,11 +71,17 @@ class TagMap final {
   std::string DebugString() const;
 
  private:
+  friend class propagation::GrpcTagsBinCache;
+
   void Initialize();
 
   std::size_t hash_;
   // TODO: add an option to store string_views to avoid copies.
   std::vector<std::pair<TagKey, std::string>> tags_;
+  // The grpc-tags-bin encoding of tags_, populated on first use and shared
+  // between copies. Only accessed through std::atomic_load/atomic_store since
+  // it is written from const methods.
+  mutable std::shared_ptr<const std::string> grpc_tags_bin_;
 };
 
 }  // namespace tags
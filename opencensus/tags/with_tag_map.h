@@ -34,6 +34,9 @@ namespace tags {
 //   WithTagMap wt(tags);
 //   // Do work.
 // }
+//
+// When built with OPENCENSUS_DISABLE_INSTRUMENTATION (see README.md),
+// WithTagMap does nothing.
 class WithTagMap {
  public:
   explicit WithTagMap(const TagMap& tags, bool cond = true);
@@ -47,15 +50,23 @@ class WithTagMap {
   WithTagMap& operator=(const WithTagMap&) = delete;
   WithTagMap& operator=(WithTagMap&&) = delete;
 
+#ifndef OPENCENSUS_DISABLE_INSTRUMENTATION
   void ConditionalSwap();
 
-  TagMap swapped_tags_;
+  ::opencensus::context::Context swapped_context_;
 #ifndef NDEBUG
   const ::opencensus::context::Context* original_context_;
 #endif
   const bool cond_;
+#endif  // OPENCENSUS_DISABLE_INSTRUMENTATION
 };
 
+#ifdef OPENCENSUS_DISABLE_INSTRUMENTATION
+inline WithTagMap::WithTagMap(const TagMap& /*tags*/, bool /*cond*/) {}
+inline WithTagMap::WithTagMap(TagMap&& /*tags*/, bool /*cond*/) {}
+inline WithTagMap::~WithTagMap() {}
+#endif  // OPENCENSUS_DISABLE_INSTRUMENTATION
+
 }  // namespace tags
 }  // namespace opencensus
 
@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "opencensus/trace/static_string.h"
 
 namespace opencensus {
 namespace trace {
@@ -56,6 +57,12 @@ class AttributeValueRef final {
   AttributeValueRef(const char* string_value)
       : string_value_(string_value), type_(Type::kString) {}
 
+  // Construct from a StaticString, which is recorded without being copied.
+  AttributeValueRef(StaticString string_value)
+      : string_value_(string_value),
+        type_(Type::kString),
+        static_storage_(true) {}
+
   // Construct from std::string.
   template <typename Allocator>
   AttributeValueRef(const std::basic_string<char, std::char_traits<char>,
@@ -78,6 +85,12 @@ class AttributeValueRef final {
   // Accessors. The caller must ensure that the AttributeValueRef object is of
   // the corresponding type before accessing its value.
   Type type() const { return type_; }
+  // True if this is a string that never needs to be copied: a StaticString, or
+  // an interned string.
+  bool has_static_storage() const {
+    return static_storage_ ||
+           (type_ == Type::kString && StaticString::IsInterned(string_value_));
+  }
   absl::string_view string_value() const;
   bool bool_value() const;
   int64_t int_value() const;
@@ -97,6 +110,7 @@ class AttributeValueRef final {
     bool bool_value_;
   };
   Type type_;
+  bool static_storage_ = false;
 };
 
 }  // namespace trace
@@ -0,0 +1,210 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_TRACE_EXPORTER_SPAN_BATCH_H_
+#define OPENCENSUS_TRACE_EXPORTER_SPAN_BATCH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "opencensus/trace/attribute_value_ref.h"
+#include "opencensus/trace/exporter/link.h"
+#include "opencensus/trace/exporter/message_event.h"
+#include "opencensus/trace/span_id.h"
+#include "opencensus/trace/status_code.h"
+#include "opencensus/trace/trace_id.h"
+#include "opencensus/trace/trace_options.h"
+
+namespace opencensus {
+namespace trace {
+
+class SpanImpl;
+struct ArenaAttribute;
+
+namespace exporter {
+
+class SpanExporterImpl;
+
+// SpanBatch is a columnar representation of a batch of ended spans, for
+// exporters that encode many spans at once (see SpanExporter::BatchHandler).
+//
+// Span i is described by element i of each per-span column. Its attributes,
+// annotations, message events and links are the Range of elements of the
+// corresponding nested column. Span names, attribute keys, string attribute
+// values, annotation descriptions and status messages are StringIndexes into
+// a string table that holds each distinct string once per batch. Times are
+// nanoseconds since the Unix epoch.
+//
+// SpanBatch is immutable once built, and thread-compatible.
+class SpanBatch final {
+ public:
+  using StringIndex = uint32_t;
+
+  // The half-open range [begin, end) of elements of a nested column.
+  struct Range {
+    uint32_t begin;
+    uint32_t end;
+
+    uint32_t size() const { return end - begin; }
+  };
+
+  struct Attribute {
+    StringIndex key;
+    AttributeValueRef::Type type;
+    // The StringIndex of a string, the value of an int, or 0 or 1 for a bool.
+    int64_t value;
+  };
+
+  struct Annotation {
+    int64_t time;
+    StringIndex description;
+    Range attributes;
+  };
+
+  struct MessageEvent {
+    int64_t time;
+    exporter::MessageEvent event;
+  };
+
+  struct Link {
+    TraceId trace_id;
+    SpanId span_id;
+    exporter::Link::Type type;
+    Range attributes;
+  };
+
+  SpanBatch();
+  ~SpanBatch();
+  SpanBatch(SpanBatch&&);
+  SpanBatch& operator=(SpanBatch&&);
+  SpanBatch(const SpanBatch&) = delete;
+  SpanBatch& operator=(const SpanBatch&) = delete;
+
+  // The number of spans.
+  size_t size() const { return names_.size(); }
+  bool empty() const { return names_.empty(); }
+
+  // The string table. Strings stay valid as long as the SpanBatch.
+  absl::string_view string(StringIndex index) const { return strings_[index]; }
+  const std::vector<absl::string_view>& strings() const { return strings_; }
+
+  // Per-span columns.
+  const std::vector<TraceId>& trace_ids() const { return trace_ids_; }
+  const std::vector<SpanId>& span_ids() const { return span_ids_; }
+  const std::vector<TraceOptions>& trace_options() const {
+    return trace_options_;
+  }
+  // Invalid for root spans.
+  const std::vector<SpanId>& parent_span_ids() const {
+    return parent_span_ids_;
+  }
+  const std::vector<bool>& has_remote_parent() const {
+    return has_remote_parent_;
+  }
+  const std::vector<StringIndex>& names() const { return names_; }
+  const std::vector<int64_t>& start_times() const { return start_times_; }
+  const std::vector<int64_t>& end_times() const { return end_times_; }
+  const std::vector<StatusCode>& status_codes() const { return status_codes_; }
+  const std::vector<StringIndex>& status_messages() const {
+    return status_messages_;
+  }
+  const std::vector<Range>& attribute_ranges() const {
+    return attribute_ranges_;
+  }
+  const std::vector<Range>& annotation_ranges() const {
+    return annotation_ranges_;
+  }
+  const std::vector<Range>& message_event_ranges() const {
+    return message_event_ranges_;
+  }
+  const std::vector<Range>& link_ranges() const { return link_ranges_; }
+  const std::vector<uint32_t>& num_attributes_dropped() const {
+    return num_attributes_dropped_;
+  }
+  const std::vector<uint32_t>& num_annotations_dropped() const {
+    return num_annotations_dropped_;
+  }
+  const std::vector<uint32_t>& num_message_events_dropped() const {
+    return num_message_events_dropped_;
+  }
+  const std::vector<uint32_t>& num_links_dropped() const {
+    return num_links_dropped_;
+  }
+
+  // Nested columns, shared by all spans.
+  const std::vector<Attribute>& attributes() const { return attributes_; }
+  const std::vector<Annotation>& annotations() const { return annotations_; }
+  const std::vector<MessageEvent>& message_events() const {
+    return message_events_;
+  }
+  const std::vector<Link>& links() const { return links_; }
+
+ private:
+  friend class ::opencensus::trace::SpanImpl;
+  friend class SpanExporterImpl;
+
+  // Returns the index of s in the string table, adding it if needed. Static
+  // and interned strings are referenced rather than copied.
+  StringIndex AddString(absl::string_view s, bool is_static = false);
+
+  // Appends attributes to the nested column and returns their range.
+  Range AddAttributes(absl::Span<const ArenaAttribute> attributes);
+
+  // Reserves space for n more spans in the per-span columns.
+  void Reserve(size_t n);
+
+  // Frees the memory only needed while adding spans.
+  void FinishBuilding();
+
+  // Holds copies of the strings in strings_, and indexes them while spans
+  // are added. Defined in span_batch.cc.
+  struct StringStorage;
+
+  std::unique_ptr<StringStorage> string_storage_;
+  std::vector<absl::string_view> strings_;
+
+  std::vector<TraceId> trace_ids_;
+  std::vector<SpanId> span_ids_;
+  std::vector<TraceOptions> trace_options_;
+  std::vector<SpanId> parent_span_ids_;
+  std::vector<bool> has_remote_parent_;
+  std::vector<StringIndex> names_;
+  std::vector<int64_t> start_times_;
+  std::vector<int64_t> end_times_;
+  std::vector<StatusCode> status_codes_;
+  std::vector<StringIndex> status_messages_;
+  std::vector<Range> attribute_ranges_;
+  std::vector<Range> annotation_ranges_;
+  std::vector<Range> message_event_ranges_;
+  std::vector<Range> link_ranges_;
+  std::vector<uint32_t> num_attributes_dropped_;
+  std::vector<uint32_t> num_annotations_dropped_;
+  std::vector<uint32_t> num_message_events_dropped_;
+  std::vector<uint32_t> num_links_dropped_;
+
+  std::vector<Attribute> attributes_;
+  std::vector<Annotation> annotations_;
+  std::vector<MessageEvent> message_events_;
+  std::vector<Link> links_;
+};
+
+}  // namespace exporter
+}  // namespace trace
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_TRACE_EXPORTER_SPAN_BATCH_H_
@@ -15,10 +15,16 @@
 #ifndef OPENCENSUS_TRACE_EXPORTER_SPAN_EXPORTER_H_
 #define OPENCENSUS_TRACE_EXPORTER_SPAN_EXPORTER_H_
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "opencensus/trace/exporter/span_batch.h"
 #include "opencensus/trace/exporter/span_data.h"
 
 namespace opencensus {
@@ -44,18 +50,114 @@ class SpanExporter final {
   // per-exporter.
   static void SetInterval(absl::Duration interval);
 
+  // What to do with an ended span when the buffer of spans waiting to be
+  // exported is full.
+  enum class OverflowPolicy {
+    // Drop the span that just ended.
+    kDropNewest,
+    // Drop the oldest buffered span to make room.
+    kDropOldest,
+    // Once the buffer is half full, keep a fraction of traces chosen by
+    // TraceId, so that spans of the same trace are kept or dropped together.
+    // The fraction halves each time the buffer fills further, which drops the
+    // rest of half the kept traces, and is restored only after the load has
+    // stayed low for an export interval. Completeness is best-effort. Drop
+    // the span that just ended when the buffer is full.
+    kSampleByTrace,
+  };
+
+  // The largest buffer that SetBufferOptions() accepts.
+  static constexpr size_t kMaxBufferedSpans = 16384;
+
+  struct BufferOptions {
+    // The maximum number of ended spans waiting to be exported, between 1 and
+    // kMaxBufferedSpans.
+    size_t max_spans = kMaxBufferedSpans;
+    OverflowPolicy overflow_policy = OverflowPolicy::kDropNewest;
+  };
+
+  // Sets the budget and overflow policy of the buffer of ended spans waiting
+  // to be exported. This bounds the memory held by spans while export falls
+  // behind, e.g. during a backend outage.
+  static void SetBufferOptions(const BufferOptions& options);
+
+  // Statistics for the buffer of spans waiting to be exported. Drop counts are
+  // cumulative.
+  struct BufferStats {
+    // The number of spans waiting to be exported.
+    size_t buffered_spans = 0;
+    // Spans dropped on arrival because the buffer was full.
+    uint64_t dropped_newest = 0;
+    // Buffered spans dropped to make room, with OverflowPolicy::kDropOldest.
+    uint64_t dropped_oldest = 0;
+    // Spans dropped by OverflowPolicy::kSampleByTrace before the buffer filled
+    // up.
+    uint64_t dropped_by_trace = 0;
+  };
+
+  static BufferStats GetBufferStats();
+
   // Handlers allow different tracing services to export recorded data for
   // sampled spans in their own format. Every exporter must provide a static
   // Register() method that takes any arguments needed by the exporter (e.g. a
   // URL to export to) and calls SpanExporter::RegisterHandler itself.
+  //
+  // Each Handler has its own queue of batches and its own thread, which calls
+  // Export(), so a slow Handler delays neither the others nor the
+  // application. If a Handler falls behind by more than kHandlerQueueCapacity
+  // spans, new batches are dropped for that Handler only.
   class Handler {
    public:
     virtual ~Handler() = default;
     virtual void Export(const std::vector<SpanData>& spans) = 0;
   };
 
-  // This should only be called by Handler's Register() method.
-  static void RegisterHandler(std::unique_ptr<Handler> handler);
+  // A BatchHandler is an alternative to a Handler for exporters that encode
+  // many spans at once: it receives the same spans as a columnar SpanBatch,
+  // whose strings are deduplicated, instead of a SpanData per span. Each batch
+  // is built once and shared by all BatchHandlers. BatchHandlers are queued
+  // and run like Handlers.
+  class BatchHandler {
+   public:
+    virtual ~BatchHandler() = default;
+    virtual void Export(const SpanBatch& batch) = 0;
+  };
+
+  // The maximum number of spans waiting to be passed to each Handler or
+  // BatchHandler.
+  static constexpr size_t kHandlerQueueCapacity = 16384;
+
+  // This should only be called by Handler's Register() method. The name
+  // identifies the Handler in GetHandlerStats().
+  static void RegisterHandler(std::unique_ptr<Handler> handler,
+                              absl::string_view name = "");
+
+  // Like RegisterHandler(), for a BatchHandler.
+  static void RegisterBatchHandler(std::unique_ptr<BatchHandler> handler,
+                                   absl::string_view name = "");
+
+  // The number of buckets in HandlerStats::export_latency_counts.
+  static constexpr size_t kNumExportLatencyBuckets = 9;
+
+  // Export statistics for a registered Handler or BatchHandler.
+  struct HandlerStats {
+    // The name passed to RegisterHandler() or RegisterBatchHandler().
+    std::string name;
+    // The number of spans passed to Export().
+    uint64_t exported_spans = 0;
+    // The number of spans dropped because the Handler's queue was full.
+    uint64_t dropped_spans = 0;
+    // The number of batches waiting to be exported.
+    size_t queued_batches = 0;
+    // The number of Export() calls by duration, in the same half-open buckets
+    // as LocalSpanStore latencies: [0, 10us), [10us, 100us), ..., [10s, 100s),
+    // [100s, inf).
+    std::array<uint64_t, kNumExportLatencyBuckets> export_latency_counts{};
+  };
+
+  // Returns the statistics of every registered Handler and BatchHandler, in
+  // registration order.
+  static std::vector<HandlerStats> GetHandlerStats();
 
  private:
   SpanExporter() = delete;
@@ -0,0 +1,57 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_TRACE_EXPORTER_SPAN_EXPORTER_METRICS_H_
+#define OPENCENSUS_TRACE_EXPORTER_SPAN_EXPORTER_METRICS_H_
+
+#include "opencensus/stats/view_descriptor.h"
+
+namespace opencensus {
+namespace trace {
+namespace exporter {
+
+// SpanExporterMetrics records the state of the SpanExporter's buffer of spans
+// waiting to be exported (see SpanExporter::GetBufferStats()) as stats, so
+// that drops show up next to the application's other metrics.
+//
+// Measures:
+//   opencensus.io/trace/exporter/dropped_spans: spans dropped from the buffer,
+//     tagged with "reason": "drop_newest", "drop_oldest" or "sample_by_trace".
+//   opencensus.io/trace/exporter/buffered_spans: spans in the buffer.
+//
+// This class is thread-safe.
+class SpanExporterMetrics final {
+ public:
+  // Starts recording the buffer statistics after each export by the
+  // SpanExporter's worker. Calling this more than once has no effect.
+  static void Enable();
+
+  // Enables recording and registers both views for export.
+  static void RegisterViewsForExport();
+
+  // The sum of dropped_spans, by reason.
+  static const stats::ViewDescriptor& DroppedSpansView();
+
+  // The last value of buffered_spans.
+  static const stats::ViewDescriptor& BufferedSpansView();
+
+ private:
+  SpanExporterMetrics() = delete;
+};
+
+}  // namespace exporter
+}  // namespace trace
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_TRACE_EXPORTER_SPAN_EXPORTER_METRICS_H_
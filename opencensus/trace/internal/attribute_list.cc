@@ -14,15 +14,116 @@
 
 #include "opencensus/trace/internal/attribute_list.h"
 
+#include <algorithm>
+#include <cstring>
+#include <new>
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "opencensus/trace/static_string.h"
 
 namespace opencensus {
 namespace trace {
 
+namespace {
+// The capacity of the first array allocated, unless max_attributes is lower.
+constexpr uint32_t kInitialCapacity = 16;
+
+AttributeValueRef CopyValue(AttributeValueRef value, common::Arena* arena) {
+  if (value.type() == AttributeValueRef::Type::kString &&
+      !value.has_static_storage()) {
+    return AttributeValueRef(arena->CopyString(value.string_value()));
+  }
+  return value;
+}
+
+// Returns the number of bytes copied for the value's string, if any.
+uint32_t StorageSize(AttributeValueRef value) {
+  return value.type() == AttributeValueRef::Type::kString &&
+                 !value.has_static_storage()
+             ? static_cast<uint32_t>(value.string_value().size())
+             : 0;
+}
+
+// Replaces *old, which AttributeList owns, with a copy of value. A string that
+// fits in the *storage bytes that were copied for an earlier value is written
+// over it instead of being copied into the arena.
+void UpdateValue(AttributeValueRef value, AttributeValueRef* old,
+                 uint32_t* storage, common::Arena* arena) {
+  if (value.type() != AttributeValueRef::Type::kString ||
+      value.has_static_storage()) {
+    *old = value;
+    return;
+  }
+  const absl::string_view from = value.string_value();
+  if (old->type() == AttributeValueRef::Type::kString &&
+      !old->has_static_storage() && from.size() <= *storage) {
+    char* to = const_cast<char*>(old->string_value().data());
+    if (!from.empty()) memmove(to, from.data(), from.size());
+    *old = AttributeValueRef(absl::string_view(to, from.size()));
+    return;
+  }
+  *old = CopyValue(value, arena);
+  *storage = StorageSize(*old);
+}
+}  // namespace
+
+absl::string_view CopyString(absl::string_view s, common::Arena* arena) {
+  return StaticString::IsInterned(s) ? s : arena->CopyString(s);
+}
+
+ArenaAttribute CopyAttribute(absl::string_view key, AttributeValueRef value,
+                             common::Arena* arena) {
+  return ArenaAttribute{CopyString(key, arena), CopyValue(value, arena)};
+}
+
+absl::Span<const ArenaAttribute> CopyAttributes(
+    absl::Span<const std::pair<absl::string_view, AttributeValueRef>>
+        attributes,
+    common::Arena* arena) {
+  if (attributes.size() == 0) return {};
+  ArenaAttribute* out = arena->AllocateArray<ArenaAttribute>(attributes.size());
+  size_t size = 0;
+  for (const auto& pair : attributes) {
+    ArenaAttribute* existing =
+        std::find_if(out, out + size, [&](const ArenaAttribute& attribute) {
+          return attribute.key == pair.first;
+        });
+    if (existing != out + size) {
+      // Already exists, update.
+      existing->value = CopyValue(pair.second, arena);
+    } else {
+      new (&out[size++]) ArenaAttribute(CopyAttribute(pair.first, pair.second,
+                                                      arena));
+    }
+  }
+  return absl::Span<const ArenaAttribute>(out, size);
+}
+
+absl::Span<const ArenaAttribute> CopyAttributes(
+    absl::Span<const ArenaAttribute> attributes, common::Arena* arena) {
+  if (attributes.empty()) return {};
+  ArenaAttribute* out = arena->AllocateArray<ArenaAttribute>(attributes.size());
+  for (size_t i = 0; i < attributes.size(); ++i) {
+    new (&out[i]) ArenaAttribute(
+        CopyAttribute(attributes[i].key, attributes[i].value, arena));
+  }
+  return absl::Span<const ArenaAttribute>(out, attributes.size());
+}
+
+std::unordered_map<std::string, exporter::AttributeValue> ToAttributeMap(
+    absl::Span<const ArenaAttribute> attributes) {
+  std::unordered_map<std::string, exporter::AttributeValue> out;
+  out.reserve(attributes.size());
+  for (const auto& attribute : attributes) {
+    out.emplace(std::string(attribute.key),
+                exporter::AttributeValue(attribute.value));
+  }
+  return out;
+}
+
 uint32_t AttributeList::num_attributes_dropped() const {
-  return total_recorded_attributes_ - attributes_.size();
+  return total_recorded_attributes_ - size_;
 }
 
 uint32_t AttributeList::num_attributes_added() const {
@@ -30,27 +131,89 @@ uint32_t AttributeList::num_attributes_added() const {
 }
 
 void AttributeList::AddAttribute(absl::string_view key,
-                                 exporter::AttributeValue&& value) {
+                                 AttributeValueRef value,
+                                 common::Arena* arena) {
   // Blank span has 0 max attributes.
   if (max_attributes_ == 0) {
     return;
   }
 
-  std::string key_string(key);
-  auto it = attributes_.find(key_string);
-  if (it != attributes_.end()) {
-    it->second = std::move(value);
+  ArenaAttribute* existing = FindAttribute(key);
+  if (existing != nullptr) {
+    // Move the attribute to the back, as the most recently used.
+    const uint32_t i = static_cast<uint32_t>(existing - attributes_);
+    const ArenaAttribute attribute = attributes_[i];
+    const uint32_t storage = value_storage_[i];
+    Erase(i);
+    attributes_[size_] = attribute;
+    value_storage_[size_] = storage;
+    UpdateValue(value, &attributes_[size_].value, &value_storage_[size_],
+                arena);
+    ++size_;
     return;
   }
 
-  if (attributes_.size() >= max_attributes_) {
-    // TODO: This should be changed to a LRU mechanism.  Just remove
-    // first element for now.
-    attributes_.erase(attributes_.begin());
+  if (size_ >= max_attributes_) {
+    // Evict the least recently used attribute.
+    Erase(0);
+  } else if (size_ == capacity_) {
+    // Grow. The old arrays are reclaimed when the arena is.
+    capacity_ = capacity_ == 0 ? std::min(kInitialCapacity, max_attributes_)
+                               : std::min(2 * capacity_, max_attributes_);
+    ArenaAttribute* attributes =
+        arena->AllocateArray<ArenaAttribute>(capacity_);
+    uint32_t* value_storage = arena->AllocateArray<uint32_t>(capacity_);
+    if (size_ > 0) {
+      memcpy(static_cast<void*>(attributes), attributes_,
+             size_ * sizeof(ArenaAttribute));
+      memcpy(value_storage, value_storage_, size_ * sizeof(uint32_t));
+    }
+    attributes_ = attributes;
+    value_storage_ = value_storage;
   }
-  attributes_.insert({key_string, std::move(value)});
+  new (&attributes_[size_]) ArenaAttribute(CopyAttribute(key, value, arena));
+  value_storage_[size_] = StorageSize(attributes_[size_].value);
+  ++size_;
   total_recorded_attributes_++;
 }
 
+void AttributeList::Erase(uint32_t i) {
+  memmove(static_cast<void*>(attributes_ + i), attributes_ + i + 1,
+          (size_ - i - 1) * sizeof(ArenaAttribute));
+  memmove(value_storage_ + i, value_storage_ + i + 1,
+          (size_ - i - 1) * sizeof(uint32_t));
+  --size_;
+}
+
+const AttributeValueRef* AttributeList::Find(absl::string_view key) const {
+  const ArenaAttribute* attribute = FindAttribute(key);
+  return attribute == nullptr ? nullptr : &attribute->value;
+}
+
+ArenaAttribute* AttributeList::FindAttribute(absl::string_view key) const {
+  for (uint32_t i = 0; i < size_; ++i) {
+    if (attributes_[i].key == key) return &attributes_[i];
+  }
+  return nullptr;
+}
+
+void AttributeList::MoveTo(common::Arena* arena) {
+  if (size_ == 0) {
+    attributes_ = nullptr;
+    value_storage_ = nullptr;
+    capacity_ = 0;
+    return;
+  }
+  ArenaAttribute* attributes = arena->AllocateArray<ArenaAttribute>(capacity_);
+  uint32_t* value_storage = arena->AllocateArray<uint32_t>(capacity_);
+  for (uint32_t i = 0; i < size_; ++i) {
+    new (&attributes[i]) ArenaAttribute(
+        CopyAttribute(attributes_[i].key, attributes_[i].value, arena));
+    value_storage[i] = StorageSize(attributes[i].value);
+  }
+  attributes_ = attributes;
+  value_storage_ = value_storage;
+}
+
 }  // namespace trace
 }  // namespace opencensus
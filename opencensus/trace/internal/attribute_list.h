@@ -18,16 +18,55 @@
 #include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "opencensus/common/internal/arena.h"
+#include "opencensus/trace/attribute_value_ref.h"
 #include "opencensus/trace/exporter/attribute_value.h"
 
 namespace opencensus {
 namespace trace {
 
-// Stores a list of AttributesValues that are recorded within a span. The
-// AttributeValues are stored in an unordered fashion and accessed with a
-// string key. AttributeList is thread-compatible.
+// An attribute whose key and string value point into a common::Arena, or are
+// static strings.
+struct ArenaAttribute {
+  absl::string_view key;
+  AttributeValueRef value;
+};
+
+// Returns s if it is an interned StaticString, otherwise a copy of s in the
+// arena.
+absl::string_view CopyString(absl::string_view s, common::Arena* arena);
+
+// Returns a copy of the attribute, with its strings copied into the arena
+// unless they are static.
+ArenaAttribute CopyAttribute(absl::string_view key, AttributeValueRef value,
+                             common::Arena* arena);
+
+// Copies attributes into the arena. If the same key appears multiple times, the
+// last value wins.
+absl::Span<const ArenaAttribute> CopyAttributes(
+    absl::Span<const std::pair<absl::string_view, AttributeValueRef>>
+        attributes,
+    common::Arena* arena);
+
+// Copies attributes that are already in an arena into another.
+absl::Span<const ArenaAttribute> CopyAttributes(
+    absl::Span<const ArenaAttribute> attributes, common::Arena* arena);
+
+// Deep-copies attributes to the exporter representation.
+std::unordered_map<std::string, exporter::AttributeValue> ToAttributeMap(
+    absl::Span<const ArenaAttribute> attributes);
+
+// Stores a list of attributes that are recorded within a span, ordered from
+// least to most recently added or updated. When the list is full, the least
+// recently used attribute is evicted. Keys and values are copied into the
+// caller's Arena unless they are static strings, and the array holding them is
+// allocated from it on the first AddAttribute(). Updating an attribute with a
+// string no longer than the previous copy reuses its storage. AttributeList is
+// thread-compatible.
 class AttributeList final {
  public:
   explicit AttributeList(uint32_t max_attributes = 0)
@@ -39,22 +78,39 @@ class AttributeList final {
   // Returns the number of recorded attributes, including dropped attributes.
   uint32_t num_attributes_added() const;
 
-  // Adds an AttributeValue to the list or updates an existing AttributeValue.
-  // If max_attributes_ is exceeded, it will evict one of the previous
-  // AttributeValues.
-  void AddAttribute(absl::string_view key, exporter::AttributeValue&& value);
+  // Adds an attribute to the list or updates an existing one, making it the
+  // most recently used. If max_attributes_ is exceeded, the least recently
+  // used attribute is evicted.
+  void AddAttribute(absl::string_view key, AttributeValueRef value,
+                    common::Arena* arena);
+
+  // Returns the value of the attribute with the given key, or nullptr. It is
+  // valid until the next call to a non-const method.
+  const AttributeValueRef* Find(absl::string_view key) const;
 
-  // Returns an unordered map of all the attributes that are currently contained
-  // within the list.
-  const std::unordered_map<std::string, exporter::AttributeValue>& attributes()
-      const {
-    return attributes_;
+  // Returns the attributes currently contained within the list, least recently
+  // used first. They are valid until the next call to a non-const method.
+  absl::Span<const ArenaAttribute> attributes() const {
+    return absl::Span<const ArenaAttribute>(attributes_, size_);
   }
 
+  // Copies all attributes into arena, so that the previous arena can be
+  // released.
+  void MoveTo(common::Arena* arena);
+
  private:
+  ArenaAttribute* FindAttribute(absl::string_view key) const;
+  // Removes the i-th attribute.
+  void Erase(uint32_t i);
+
   uint32_t total_recorded_attributes_;
   const uint32_t max_attributes_;
-  std::unordered_map<std::string, exporter::AttributeValue> attributes_;
+  ArenaAttribute* attributes_ = nullptr;
+  // The number of bytes allocated for the string value of each attribute,
+  // which may be more than its current size.
+  uint32_t* value_storage_ = nullptr;
+  uint32_t size_ = 0;
+  uint32_t capacity_ = 0;
 };
 
 }  // namespace trace
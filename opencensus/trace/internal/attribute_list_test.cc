@@ -0,0 +1,109 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/internal/attribute_list.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+#include "opencensus/common/internal/arena.h"
+#include "opencensus/trace/static_string.h"
+
+namespace opencensus {
+namespace trace {
+namespace {
+
+std::vector<std::string> Keys(const AttributeList& list) {
+  std::vector<std::string> keys;
+  for (const auto& attribute : list.attributes()) {
+    keys.emplace_back(attribute.key);
+  }
+  return keys;
+}
+
+TEST(AttributeListTest, EvictsLeastRecentlyUsed) {
+  common::Arena arena;
+  AttributeList list(3);
+  list.AddAttribute("a", 1, &arena);
+  list.AddAttribute("b", 2, &arena);
+  list.AddAttribute("c", 3, &arena);
+  list.AddAttribute("a", 4, &arena);
+  EXPECT_EQ(std::vector<std::string>({"b", "c", "a"}), Keys(list));
+
+  list.AddAttribute("d", 5, &arena);
+  EXPECT_EQ(std::vector<std::string>({"c", "a", "d"}), Keys(list));
+  EXPECT_EQ(nullptr, list.Find("b"));
+  ASSERT_NE(nullptr, list.Find("a"));
+  EXPECT_EQ(4, list.Find("a")->int_value());
+  // Updates are not counted.
+  EXPECT_EQ(4, list.num_attributes_added());
+  EXPECT_EQ(1, list.num_attributes_dropped());
+}
+
+TEST(AttributeListTest, ShorterStringUpdatesDoNotAllocate) {
+  common::Arena arena;
+  AttributeList list(4);
+  list.AddAttribute("key", "a long initial value", &arena);
+  list.AddAttribute("other", true, &arena);
+  const size_t allocated = arena.bytes_allocated();
+  for (int i = 0; i < 100; ++i) {
+    list.AddAttribute("key", absl::StrCat("value ", i), &arena);
+  }
+  EXPECT_EQ(allocated, arena.bytes_allocated());
+  EXPECT_EQ("value 99", list.Find("key")->string_value());
+
+  list.AddAttribute("key", "a value longer than the initial one", &arena);
+  EXPECT_EQ("a value longer than the initial one",
+            list.Find("key")->string_value());
+  EXPECT_TRUE(list.Find("other")->bool_value());
+}
+
+TEST(AttributeListTest, StaticStringsAreNotCopied) {
+  static const StaticString kKey = StaticString::Intern("static key");
+  common::Arena arena;
+  AttributeList list(4);
+  list.AddAttribute(kKey, StaticString::Literal("static value"), &arena);
+  // Only the list's arrays are allocated.
+  EXPECT_EQ(4 * (sizeof(ArenaAttribute) + sizeof(uint32_t)),
+            arena.bytes_allocated());
+  const auto attributes = list.attributes();
+  ASSERT_EQ(1, attributes.size());
+  EXPECT_EQ(kKey.view().data(), attributes[0].key.data());
+  EXPECT_EQ("static value", attributes[0].value.string_value());
+
+  // A shorter value must not be written over the static one.
+  list.AddAttribute(kKey, "short", &arena);
+  EXPECT_EQ("short", list.Find(kKey)->string_value());
+  list.AddAttribute(kKey, StaticString::Literal("static value"), &arena);
+  EXPECT_EQ("static value", list.Find(kKey)->string_value());
+}
+
+TEST(AttributeListTest, MoveTo) {
+  common::Arena arena;
+  AttributeList list(4);
+  list.AddAttribute("key", "value", &arena);
+  list.AddAttribute("int", 42, &arena);
+  common::Arena new_arena;
+  list.MoveTo(&new_arena);
+  arena = common::Arena();
+  EXPECT_EQ(std::vector<std::string>({"key", "int"}), Keys(list));
+  EXPECT_EQ("value", list.Find("key")->string_value());
+  EXPECT_EQ(42, list.Find("int")->int_value());
+}
+
+}  // namespace
+}  // namespace trace
+}  // namespace opencensus
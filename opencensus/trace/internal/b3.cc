@@ -15,11 +15,9 @@
 #include "opencensus/trace/propagation/b3.h"
 
 #include <cstdint>
-#include <cstring>
 #include <string>
 
-#include "absl/strings/ascii.h"
-#include "absl/strings/escaping.h"
+#include "opencensus/common/internal/hex.h"
 #include "opencensus/trace/span_context.h"
 #include "opencensus/trace/span_id.h"
 #include "opencensus/trace/trace_id.h"
@@ -29,18 +27,6 @@ namespace opencensus {
 namespace trace {
 namespace propagation {
 
-namespace {
-
-// Returns true if the string only contains valid hex digits.
-bool IsHexDigits(absl::string_view s) {
-  for (int i = 0; i < s.length(); ++i) {
-    if (!absl::ascii_isxdigit(s[i])) return false;
-  }
-  return true;
-}
-
-}  // namespace
-
 SpanContext FromB3Headers(absl::string_view b3_trace_id,
                           absl::string_view b3_span_id,
                           absl::string_view b3_sampled,
@@ -65,45 +51,40 @@ SpanContext FromB3Headers(absl::string_view b3_trace_id,
   if (b3_trace_id.length() != 32 && b3_trace_id.length() != 16) return invalid;
   if (b3_span_id.length() != 16) return invalid;
 
-  if (!IsHexDigits(b3_trace_id)) {
+  // A 64-bit trace_id is extended to 128 bits with leading zeros.
+  uint8_t trace_id_binary[TraceId::kSize] = {};
+  uint8_t span_id_binary[SpanId::kSize];
+  if (!common::HexToBytes(
+          b3_trace_id,
+          trace_id_binary + TraceId::kSize - b3_trace_id.length() / 2) ||
+      !common::HexToBytes(b3_span_id, span_id_binary)) {
     return invalid;
   }
-  if (!IsHexDigits(b3_span_id)) {
-    return invalid;
-  }
-
-  std::string trace_id_binary = absl::HexStringToBytes(b3_trace_id);
-  std::string span_id_binary = absl::HexStringToBytes(b3_span_id);
-
-  uint8_t extended_trace_id[16];
 
-  // trace_id_ptr must point to a 128-bit trace_id.
-  const uint8_t* trace_id_ptr;
-  if (trace_id_binary.length() == 16) {
-    trace_id_ptr = reinterpret_cast<const uint8_t*>(trace_id_binary.data());
-  } else if (trace_id_binary.length() == 8) {
-    // Extend 64-bit trace_id to 128-bit using the buffer.
-    memset(extended_trace_id, 0, 8);
-    memcpy(extended_trace_id + 8, trace_id_binary.data(), 8);
-    trace_id_ptr = extended_trace_id;
-  } else {
-    return invalid;
-  }
-
-  return SpanContext(
-      TraceId(trace_id_ptr),
-      SpanId(reinterpret_cast<const uint8_t*>(span_id_binary.data())),
-      TraceOptions(&sampled));
+  return SpanContext(TraceId(trace_id_binary), SpanId(span_id_binary),
+                     TraceOptions(&sampled));
 }
 
 std::string ToB3TraceIdHeader(const SpanContext& ctx) {
   return ctx.trace_id().ToHex();
 }
 
+void ToB3TraceIdHeader(const SpanContext& ctx, char* out) {
+  uint8_t buf[TraceId::kSize];
+  ctx.trace_id().CopyTo(buf);
+  common::BytesToHex(buf, TraceId::kSize, out);
+}
+
 std::string ToB3SpanIdHeader(const SpanContext& ctx) {
   return ctx.span_id().ToHex();
 }
 
+void ToB3SpanIdHeader(const SpanContext& ctx, char* out) {
+  uint8_t buf[SpanId::kSize];
+  ctx.span_id().CopyTo(buf);
+  common::BytesToHex(buf, SpanId::kSize, out);
+}
+
 std::string ToB3SampledHeader(const SpanContext& ctx) {
   return ctx.trace_options().IsSampled() ? "1" : "0";
 }
@@ -43,6 +43,20 @@ void BM_FromB3Headers_InvalidTraceId(benchmark::State& state) {
 }
 BENCHMARK(BM_FromB3Headers_InvalidTraceId);
 
+void BM_ToB3HeadersBuffer(benchmark::State& state) {
+  auto ctx = FromB3Headers("463ac35c9f6413ad48485a3953bb6124",
+                           "0020000000000001", "1", "");
+  char trace_id[kB3TraceIdHeaderLen];
+  char span_id[kB3SpanIdHeaderLen];
+  while (state.KeepRunning()) {
+    ToB3TraceIdHeader(ctx, trace_id);
+    ToB3SpanIdHeader(ctx, span_id);
+    benchmark::DoNotOptimize(trace_id);
+    benchmark::DoNotOptimize(span_id);
+  }
+}
+BENCHMARK(BM_ToB3HeadersBuffer);
+
 }  // namespace
 }  // namespace propagation
 }  // namespace trace
@@ -14,6 +14,7 @@
 
 #include "opencensus/trace/propagation/b3.h"
 
+#include "absl/strings/string_view.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "opencensus/trace/span_context.h"
@@ -76,6 +77,25 @@ TEST(B3Test, DebugOverridesNotSampled) {
   EXPECT_EQ("1", ToB3SampledHeader(ctx));
 }
 
+TEST(B3Test, ToBuffer) {
+  SpanContext ctx = FromB3Headers("1234567812345678", "0020000000000001", "1",
+                                  "");
+  char trace_id[kB3TraceIdHeaderLen];
+  char span_id[kB3SpanIdHeaderLen];
+  ToB3TraceIdHeader(ctx, trace_id);
+  ToB3SpanIdHeader(ctx, span_id);
+  EXPECT_EQ("00000000000000001234567812345678",
+            absl::string_view(trace_id, sizeof(trace_id)));
+  EXPECT_EQ("0020000000000001", absl::string_view(span_id, sizeof(span_id)));
+}
+
+TEST(B3Test, UppercaseHexIsAccepted) {
+  SpanContext ctx = FromB3Headers("463AC35C9F6413AD48485A3953BB6124",
+                                  "0020000000000001", "1", "");
+  EXPECT_THAT(ctx, IsValid());
+  EXPECT_EQ("463ac35c9f6413ad48485a3953bb6124", ToB3TraceIdHeader(ctx));
+}
+
 TEST(B3Test, ExpectedFailures) {
 #define INVALID(a, b, c, d) EXPECT_THAT(FromB3Headers(a, b, c, d), IsInvalid())
   INVALID("", "", "", "");
@@ -15,17 +15,16 @@
 #include "opencensus/trace/propagation/cloud_trace_context.h"
 
 #include <cstdint>
+#include <string>
 
+#include "opencensus/common/internal/hex.h"
 #include "opencensus/trace/span_context.h"
 #include "opencensus/trace/span_id.h"
 #include "opencensus/trace/trace_id.h"
 #include "opencensus/trace/trace_options.h"
 
 #include "absl/base/internal/endian.h"
-#include "absl/strings/ascii.h"
-#include "absl/strings/escaping.h"
 #include "absl/strings/numbers.h"
-#include "absl/strings/str_cat.h"
 
 namespace opencensus {
 namespace trace {
@@ -33,14 +32,6 @@ namespace propagation {
 
 namespace {
 
-// Returns true if the string only contains valid hex digits.
-bool IsHexDigits(absl::string_view s) {
-  for (int i = 0; i < s.length(); ++i) {
-    if (!absl::ascii_isxdigit(s[i])) return false;
-  }
-  return true;
-}
-
 // Returns a SpanId which is a big-endian encoding of a decimal number.
 SpanId FromDecimal(uint64_t n) {
   uint8_t buf[8];
@@ -55,6 +46,18 @@ uint64_t ToDecimal(const SpanId& span_id) {
   return absl::big_endian::ToHost64(n);
 }
 
+// Writes n in decimal to out, and returns a pointer past the last digit.
+char* WriteDecimal(uint64_t n, char* out) {
+  char digits[20];
+  int len = 0;
+  do {
+    digits[len++] = static_cast<char>('0' + n % 10);
+    n /= 10;
+  } while (n != 0);
+  while (len > 0) *out++ = digits[--len];
+  return out;
+}
+
 }  // namespace
 
 SpanContext FromCloudTraceContextHeader(absl::string_view header) {
@@ -90,20 +93,32 @@ SpanContext FromCloudTraceContextHeader(absl::string_view header) {
   }
 
   // Parse trace_id.
-  absl::string_view trace_id = header.substr(0, kTraceIdLenHex);
-  if (!IsHexDigits(trace_id)) {
+  uint8_t trace_id_binary[kTraceIdLen];
+  if (!common::HexToBytes(header.substr(0, kTraceIdLenHex), trace_id_binary)) {
     return invalid;  // Invalid hex digit.
   }
-  std::string trace_id_binary = absl::HexStringToBytes(trace_id);
 
-  return SpanContext(
-      TraceId(reinterpret_cast<const uint8_t*>(trace_id_binary.data())),
-      FromDecimal(n_span_id), TraceOptions(&sampled));
+  return SpanContext(TraceId(trace_id_binary), FromDecimal(n_span_id),
+                     TraceOptions(&sampled));
 }
 
 std::string ToCloudTraceContextHeader(const SpanContext& ctx) {
-  return absl::StrCat(ctx.trace_id().ToHex(), "/", ToDecimal(ctx.span_id()),
-                      ctx.trace_options().IsSampled() ? ";o=1" : ";o=0");
+  char buf[kCloudTraceContextHeaderMaxLen];
+  return std::string(buf, ToCloudTraceContextHeader(ctx, buf));
+}
+
+int ToCloudTraceContextHeader(const SpanContext& ctx, char* out) {
+  uint8_t trace_id[TraceId::kSize];
+  ctx.trace_id().CopyTo(trace_id);
+  common::BytesToHex(trace_id, TraceId::kSize, out);
+  char* p = out + 2 * TraceId::kSize;
+  *p++ = '/';
+  p = WriteDecimal(ToDecimal(ctx.span_id()), p);
+  *p++ = ';';
+  *p++ = 'o';
+  *p++ = '=';
+  *p++ = ctx.trace_options().IsSampled() ? '1' : '0';
+  return static_cast<int>(p - out);
 }
 
 }  // namespace propagation
@@ -57,6 +57,15 @@ void BM_ToCloudTraceContext(benchmark::State& state) {
 }
 BENCHMARK(BM_ToCloudTraceContext);
 
+void BM_ToCloudTraceContextBuffer(benchmark::State& state) {
+  auto ctx = FromCloudTraceContextHeader(kXCTCFull);
+  char buf[kCloudTraceContextHeaderMaxLen];
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(ToCloudTraceContextHeader(ctx, buf));
+  }
+}
+BENCHMARK(BM_ToCloudTraceContextBuffer);
+
 }  // namespace
 }  // namespace propagation
 }  // namespace trace
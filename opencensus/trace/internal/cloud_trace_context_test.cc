@@ -14,6 +14,7 @@
 
 #include "opencensus/trace/propagation/cloud_trace_context.h"
 
+#include "absl/strings/string_view.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "opencensus/trace/span_context.h"
@@ -60,6 +61,22 @@ TEST(CloudTraceContextTest, ParseMaxValues) {
       << "o=3 is canonicalized to o=1";
 }
 
+TEST(CloudTraceContextTest, ToBuffer) {
+  constexpr char header[] =
+      "ffffffffffffffffffffffffffffffff/18446744073709551615;o=1";
+  char buf[kCloudTraceContextHeaderMaxLen];
+  const int len =
+      ToCloudTraceContextHeader(FromCloudTraceContextHeader(header), buf);
+  EXPECT_EQ(kCloudTraceContextHeaderMaxLen, len);
+  EXPECT_EQ(header, absl::string_view(buf, len));
+
+  constexpr char short_header[] = "01020304050607081112131415161718/1;o=0";
+  EXPECT_EQ(short_header,
+            absl::string_view(
+                buf, ToCloudTraceContextHeader(
+                         FromCloudTraceContextHeader(short_header), buf)));
+}
+
 TEST(CloudTraceContextTest, ExpectedFailures) {
 #define INVALID(str) EXPECT_THAT(FromCloudTraceContextHeader(str), IsInvalid())
   INVALID("");
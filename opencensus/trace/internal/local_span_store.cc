@@ -41,6 +41,14 @@ std::vector<SpanData> LocalSpanStore::GetSpans() {
   return LocalSpanStoreImpl::Get()->GetSpans();
 }
 
+void LocalSpanStore::SetMaxSpansPerBucket(int max_spans) {
+  LocalSpanStoreImpl::Get()->SetMaxSpansPerBucket(max_spans);
+}
+
+void LocalSpanStore::SetMaxSpanNames(int max_span_names) {
+  LocalSpanStoreImpl::Get()->SetMaxSpanNames(max_span_names);
+}
+
 }  // namespace exporter
 }  // namespace trace
 }  // namespace opencensus
@@ -34,7 +34,10 @@ namespace exporter {
 // LocalSpanStore allows users to access in-process information about Spans that
 // have completed (called End()) and were recording events.
 //
-// The LocalSpanStore has a bounded size and evicts Spans when needed.
+// For each span name, the LocalSpanStore keeps the most recent Spans in each
+// latency bucket and for each canonical status code, so that rare slow or
+// failed Spans are not evicted by frequent fast ones. Memory use is bounded by
+// SetMaxSpansPerBucket() and SetMaxSpanNames().
 //
 // This class is thread-safe.
 class LocalSpanStore {
@@ -101,6 +104,14 @@ class LocalSpanStore {
 
   // Returns SpanData for all spans in the local span store.
   static std::vector<SpanData> GetSpans();
+
+  // Sets how many Spans are kept per span name in each latency bucket and for
+  // each status code. Defaults to 10.
+  static void SetMaxSpansPerBucket(int max_spans);
+
+  // Sets how many distinct span names are tracked. Spans with other names are
+  // not stored. Defaults to 1024.
+  static void SetMaxSpanNames(int max_span_names);
 };
 
 }  // namespace exporter
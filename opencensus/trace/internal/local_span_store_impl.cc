@@ -14,32 +14,36 @@
 
 #include "opencensus/trace/internal/local_span_store_impl.h"
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <memory>
-#include <queue>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "absl/base/internal/endian.h"
 #include "absl/base/thread_annotations.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "opencensus/trace/exporter/span_data.h"
 #include "opencensus/trace/exporter/status.h"
-#include "opencensus/trace/internal/span_impl.h"
 #include "opencensus/trace/span.h"
 #include "opencensus/trace/span_context.h"
 #include "opencensus/trace/span_id.h"
+#include "opencensus/trace/status_code.h"
 
 namespace opencensus {
 namespace trace {
 namespace exporter {
 
 namespace {
-constexpr int kMaxSpans = 128;
 
 using ErrorFilter = LocalSpanStore::ErrorFilter;
 using LatencyBucketBoundary = LocalSpanStore::LatencyBucketBoundary;
@@ -47,14 +51,22 @@ using LatencyFilter = LocalSpanStore::LatencyFilter;
 using PerSpanNameSummary = LocalSpanStore::PerSpanNameSummary;
 using Summary = LocalSpanStore::Summary;
 
-// Returns a reference to the requested PerSpanNameSummary. If necessary, adds
-// it first.
-PerSpanNameSummary& GetPerSpanNameSummary(absl::string_view span_name,
-                                          LocalSpanStore::Summary* summary) {
-  const std::string name = std::string(span_name);
-  return summary->per_span_name_summary
-      .insert({name, LocalSpanStore::PerSpanNameSummary()})
-      .first->second;
+// The lower bound of each latency bucket, in nanoseconds. The upper bound is
+// the next bucket's lower bound.
+constexpr uint64_t kLatencyBucketLowerBoundNs[] = {
+    0,         10000,      100000,      1000000,     10000000,
+    100000000, 1000000000, 10000000000, 100000000000};
+constexpr size_t kNumLatencyBounds =
+    sizeof(kLatencyBucketLowerBoundNs) / sizeof(kLatencyBucketLowerBoundNs[0]);
+
+uint64_t LatencyBucketUpperBoundNs(size_t bucket) {
+  return bucket + 1 < kNumLatencyBounds
+             ? kLatencyBucketLowerBoundNs[bucket + 1]
+             : std::numeric_limits<uint64_t>::max();
+}
+
+uint64_t LatencyNs(const SpanData& span) {
+  return (span.end_time() - span.start_time()) / absl::Nanoseconds(1);
 }
 
 // Returns the LatencyBucketBoundary corresponding to the given latency.
@@ -75,42 +87,122 @@ LatencyBucketBoundary GetLatencyBucketBoundary(absl::Duration latency) {
   return LatencyBucketBoundary::k100s_plus;
 }
 
-// Increment the counter corresponding to the given key. Sets it to 1 if the key
-// wasn't present before.
-template <typename Key, typename Hash>
-void MapIncrement(const Key& key, std::unordered_map<Key, int, Hash>* map) {
-  auto iter_inserted = map->insert({key, 1});
-  if (!iter_inserted.second) {
-    // Was not inserted: needs to be incremented instead.
-    ++iter_inserted.first->second;
+static_assert(kNumLatencyBounds == LocalSpanStoreImpl::kNumLatencyBuckets,
+              "one lower bound per LatencyBucketBoundary");
+
+}  // namespace
+
+constexpr size_t LocalSpanStoreImpl::kNumLatencyBuckets;
+constexpr size_t LocalSpanStoreImpl::kNumStatusCodes;
+
+void LocalSpanStoreImpl::SampleBucket::Add(std::shared_ptr<const SpanData> span,
+                                           size_t max_spans) {
+  if (spans_.size() < max_spans) {
+    // Resize() leaves oldest_ at 0, so spans_ is in order.
+    spans_.push_back(std::move(span));
+    return;
   }
+  spans_[oldest_] = std::move(span);
+  oldest_ = (oldest_ + 1) % spans_.size();
 }
 
-}  // namespace
+void LocalSpanStoreImpl::SampleBucket::Resize(size_t max_spans) {
+  const size_t n = spans_.size();
+  const size_t keep = std::min(max_spans, n);
+  std::vector<std::shared_ptr<const SpanData>> spans;
+  spans.reserve(keep);
+  for (size_t i = n - keep; i < n; ++i) {
+    spans.push_back(std::move(spans_[(oldest_ + i) % n]));
+  }
+  spans_.swap(spans);
+  oldest_ = 0;
+}
 
 LocalSpanStoreImpl* LocalSpanStoreImpl::Get() {
   static LocalSpanStoreImpl* global_running_span_store = new LocalSpanStoreImpl;
   return global_running_span_store;
 }
 
-void LocalSpanStoreImpl::AddSpan(const std::shared_ptr<SpanImpl>& span) {
+void LocalSpanStoreImpl::AddSpans(const std::vector<SpanData>& spans) {
   absl::MutexLock l(&mu_);
-  if (spans_.size() >= kMaxSpans) {
-    spans_.pop_back();  // Make room.
+  std::string name;
+  for (const auto& span : spans) {
+    name.assign(span.name().data(), span.name().size());
+    auto it = samples_.find(name);
+    if (it == samples_.end()) {
+      if (samples_.size() >= max_span_names_) continue;
+      it = samples_.emplace(name, PerSpanNameSamples()).first;
+    }
+    auto copy = std::make_shared<const SpanData>(span);
+    const size_t code = span.status().CanonicalCode();
+    if (code < kNumStatusCodes) {
+      it->second.status[code].Add(copy, max_spans_per_bucket_);
+    }
+    it->second
+        .latency[GetLatencyBucketBoundary(span.end_time() - span.start_time())]
+        .Add(std::move(copy), max_spans_per_bucket_);
+  }
+}
+
+std::vector<bool> LocalSpanStoreImpl::SelectSpans(
+    const std::vector<SpanKey>& keys) const {
+  // The number of spans of a name that each bucket holds, newest first.
+  struct Held {
+    bool has_samples = false;
+    std::array<size_t, kNumLatencyBuckets> latency = {};
+    std::array<size_t, kNumStatusCodes> status = {};
+  };
+  std::unordered_map<absl::string_view, Held, absl::Hash<absl::string_view>>
+      held;
+  std::vector<bool> selected(keys.size(), false);
+  absl::MutexLock l(&mu_);
+  // AddSpans() adds new names oldest first, up to max_span_names_.
+  size_t num_names = samples_.size();
+  std::string name;
+  for (const auto& key : keys) {
+    if (held.count(key.name) != 0) continue;
+    name.assign(key.name.data(), key.name.size());
+    Held& h = held[key.name];
+    if (samples_.count(name) != 0) {
+      h.has_samples = true;
+    } else if (num_names < max_span_names_) {
+      h.has_samples = true;
+      ++num_names;
+    }
+  }
+  for (size_t i = keys.size(); i-- > 0;) {
+    Held& h = held[keys[i].name];
+    if (!h.has_samples) continue;
+    const size_t code = keys[i].status_code;
+    const bool in_latency =
+        h.latency[GetLatencyBucketBoundary(keys[i].latency)]++ <
+        max_spans_per_bucket_;
+    const bool in_status =
+        code < kNumStatusCodes && h.status[code]++ < max_spans_per_bucket_;
+    selected[i] = in_latency || in_status;
   }
-  spans_.emplace_front(span->ToSpanData());
+  return selected;
 }
 
 Summary LocalSpanStoreImpl::GetSummary() const {
   Summary summary;
   absl::MutexLock l(&mu_);
-  for (const auto& span : spans_) {
-    PerSpanNameSummary& curr = GetPerSpanNameSummary(span.name(), &summary);
-    const absl::Duration latency = span.end_time() - span.start_time();
-    MapIncrement(GetLatencyBucketBoundary(latency),
-                 &curr.number_of_latency_sampled_spans);
-    MapIncrement(span.status().CanonicalCode(),
-                 &curr.number_of_error_sampled_spans);
+  for (const auto& name_samples : samples_) {
+    PerSpanNameSummary& curr =
+        summary.per_span_name_summary[name_samples.first];
+    for (size_t i = 0; i < kNumLatencyBuckets; ++i) {
+      const size_t n = name_samples.second.latency[i].size();
+      if (n > 0) {
+        curr.number_of_latency_sampled_spans[static_cast<LatencyBucketBoundary>(
+            i)] = n;
+      }
+    }
+    for (size_t i = 0; i < kNumStatusCodes; ++i) {
+      const size_t n = name_samples.second.status[i].size();
+      if (n > 0) {
+        curr.number_of_error_sampled_spans[static_cast<StatusCode>(i)] = n;
+      }
+    }
   }
   return summary;
 }
@@ -118,16 +210,34 @@ Summary LocalSpanStoreImpl::GetSummary() const {
 std::vector<SpanData> LocalSpanStoreImpl::GetLatencySampledSpans(
     const LatencyFilter& filter) const {
   std::vector<SpanData> out;
-  absl::MutexLock l(&mu_);
-  for (const auto& span : spans_) {
-    uint64_t latency_ns =
-        (span.end_time() - span.start_time()) / absl::Nanoseconds(1);
-    if ((filter.span_name.empty() || (span.name() == filter.span_name)) &&
-        latency_ns >= filter.lower_latency_ns &&
-        latency_ns < filter.upper_latency_ns) {
-      out.emplace_back(span);
+  if (filter.max_spans_to_return <= 0) return out;
+  const size_t max_spans = filter.max_spans_to_return;
+  const auto add_matching = [&](const PerSpanNameSamples& samples) {
+    for (size_t i = 0; i < kNumLatencyBuckets && out.size() < max_spans; ++i) {
+      // Skip buckets that cannot overlap the filter.
+      if (kLatencyBucketLowerBoundNs[i] >= filter.upper_latency_ns ||
+          LatencyBucketUpperBoundNs(i) <= filter.lower_latency_ns) {
+        continue;
+      }
+      samples.latency[i].ForEachNewestFirst([&](const SpanData& span) {
+        const uint64_t latency_ns = LatencyNs(span);
+        if (latency_ns >= filter.lower_latency_ns &&
+            latency_ns < filter.upper_latency_ns) {
+          out.push_back(span);
+        }
+        return out.size() < max_spans;
+      });
     }
-    if (out.size() >= filter.max_spans_to_return) break;
+  };
+  absl::MutexLock l(&mu_);
+  if (!filter.span_name.empty()) {
+    const auto it = samples_.find(filter.span_name);
+    if (it != samples_.end()) add_matching(it->second);
+    return out;
+  }
+  for (const auto& name_samples : samples_) {
+    if (out.size() >= max_spans) break;
+    add_matching(name_samples.second);
   }
   return out;
 }
@@ -135,26 +245,77 @@ std::vector<SpanData> LocalSpanStoreImpl::GetLatencySampledSpans(
 std::vector<SpanData> LocalSpanStoreImpl::GetErrorSampledSpans(
     const ErrorFilter& filter) const {
   std::vector<SpanData> out;
-  absl::MutexLock l(&mu_);
-  for (const auto& span : spans_) {
-    if ((filter.span_name.empty() || (span.name() == filter.span_name)) &&
-        filter.canonical_code == span.status().CanonicalCode()) {
-      out.emplace_back(span);
+  if (filter.max_spans_to_return <= 0) return out;
+  const size_t max_spans = filter.max_spans_to_return;
+  const auto add_matching = [&](const PerSpanNameSamples& samples) {
+    for (size_t i = 0; i < kNumStatusCodes && out.size() < max_spans; ++i) {
+      if (filter.all_errors ? i == StatusCode::OK
+                            : i != filter.canonical_code) {
+        continue;
+      }
+      samples.status[i].ForEachNewestFirst([&](const SpanData& span) {
+        out.push_back(span);
+        return out.size() < max_spans;
+      });
     }
-    if (out.size() >= filter.max_spans_to_return) break;
+  };
+  absl::MutexLock l(&mu_);
+  if (!filter.span_name.empty()) {
+    const auto it = samples_.find(filter.span_name);
+    if (it != samples_.end()) add_matching(it->second);
+    return out;
+  }
+  for (const auto& name_samples : samples_) {
+    if (out.size() >= max_spans) break;
+    add_matching(name_samples.second);
   }
   return out;
 }
 
 std::vector<SpanData> LocalSpanStoreImpl::GetSpans() const {
+  std::vector<SpanData> out;
+  // A span may be in both a latency and a status bucket.
+  std::unordered_set<const SpanData*> seen;
+  const auto add_unseen = [&](const SpanData& span) {
+    if (seen.insert(&span).second) out.push_back(span);
+    return true;
+  };
   absl::MutexLock l(&mu_);
-  std::vector<SpanData> out(spans_.begin(), spans_.end());
+  for (const auto& name_samples : samples_) {
+    for (const auto& bucket : name_samples.second.latency) {
+      bucket.ForEachNewestFirst(add_unseen);
+    }
+    for (const auto& bucket : name_samples.second.status) {
+      bucket.ForEachNewestFirst(add_unseen);
+    }
+  }
   return out;
 }
 
+void LocalSpanStoreImpl::SetMaxSpansPerBucket(int max_spans) {
+  absl::MutexLock l(&mu_);
+  max_spans_per_bucket_ = std::max(1, max_spans);
+  for (auto& name_samples : samples_) {
+    for (auto& bucket : name_samples.second.latency) {
+      bucket.Resize(max_spans_per_bucket_);
+    }
+    for (auto& bucket : name_samples.second.status) {
+      bucket.Resize(max_spans_per_bucket_);
+    }
+  }
+}
+
+void LocalSpanStoreImpl::SetMaxSpanNames(int max_span_names) {
+  absl::MutexLock l(&mu_);
+  max_span_names_ = std::max(0, max_span_names);
+  while (samples_.size() > max_span_names_) {
+    samples_.erase(samples_.begin());
+  }
+}
+
 void LocalSpanStoreImpl::ClearForTesting() {
   absl::MutexLock l(&mu_);
-  spans_.clear();
+  samples_.clear();
 }
 
 }  // namespace exporter
@@ -17,8 +17,9 @@
 
 #include "opencensus/trace/internal/local_span_store.h"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -32,10 +33,10 @@
 #include "absl/time/time.h"
 #include "opencensus/trace/exporter/span_data.h"
 #include "opencensus/trace/exporter/status.h"
-#include "opencensus/trace/internal/span_impl.h"
 #include "opencensus/trace/span.h"
 #include "opencensus/trace/span_context.h"
 #include "opencensus/trace/span_id.h"
+#include "opencensus/trace/status_code.h"
 
 namespace opencensus {
 namespace trace {
@@ -46,11 +47,30 @@ namespace exporter {
 // This class is thread-safe and a singleton.
 class LocalSpanStoreImpl {
  public:
+  static constexpr size_t kNumLatencyBuckets =
+      LocalSpanStore::LatencyBucketBoundary::k100s_plus + 1;
+  static constexpr size_t kNumStatusCodes = StatusCode::UNAUTHENTICATED + 1;
+
   // Returns the global instance of LocalSpanStoreImpl.
   static LocalSpanStoreImpl* Get();
 
-  // Adds a new running Span. Only Span::End should call this.
-  void AddSpan(const std::shared_ptr<SpanImpl>& span) ABSL_LOCKS_EXCLUDED(mu_);
+  // Adds a batch of ended spans, oldest first. Only the span exporter's worker
+  // should call this, with the same SpanData it passes to export handlers.
+  void AddSpans(const std::vector<SpanData>& spans) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // What decides which buckets an ended span goes into.
+  struct SpanKey {
+    absl::string_view name;
+    absl::Duration latency;
+    StatusCode status_code;
+  };
+
+  // Returns, for each span of a batch, oldest first, whether AddSpans() would
+  // still hold it after adding the whole batch. Since each bucket keeps only
+  // its newest spans, the exporter's worker uses this to convert only these
+  // spans to SpanData when no handler needs the others.
+  std::vector<bool> SelectSpans(const std::vector<SpanKey>& keys) const
+      ABSL_LOCKS_EXCLUDED(mu_);
 
   // Returns a summary of the data available in the LocalSpanStore.
   LocalSpanStore::Summary GetSummary() const ABSL_LOCKS_EXCLUDED(mu_);
@@ -65,9 +85,45 @@ class LocalSpanStoreImpl {
 
   std::vector<SpanData> GetSpans() const ABSL_LOCKS_EXCLUDED(mu_);
 
+  void SetMaxSpansPerBucket(int max_spans) ABSL_LOCKS_EXCLUDED(mu_);
+  void SetMaxSpanNames(int max_span_names) ABSL_LOCKS_EXCLUDED(mu_);
+
  private:
   friend class LocalSpanStoreImplTestPeer;
 
+  // The most recently added spans, up to a limit. Adding a span is O(1): once
+  // the limit is reached, the oldest span is overwritten.
+  class SampleBucket {
+   public:
+    void Add(std::shared_ptr<const SpanData> span, size_t max_spans);
+
+    // Keeps only the newest max_spans spans.
+    void Resize(size_t max_spans);
+
+    // Calls f on each span, newest first, until f returns false.
+    template <typename F>
+    void ForEachNewestFirst(F f) const {
+      const size_t n = spans_.size();
+      for (size_t i = 1; i <= n; ++i) {
+        if (!f(*spans_[(oldest_ + n - i) % n])) return;
+      }
+    }
+
+    size_t size() const { return spans_.size(); }
+
+   private:
+    std::vector<std::shared_ptr<const SpanData>> spans_;
+    // The index of the oldest span, once spans_ has wrapped around.
+    size_t oldest_ = 0;
+  };
+
+  // Each span is kept in the bucket for its latency and in the bucket for its
+  // status code; both hold a reference to the same SpanData.
+  struct PerSpanNameSamples {
+    std::array<SampleBucket, kNumLatencyBuckets> latency;
+    std::array<SampleBucket, kNumStatusCodes> status;
+  };
+
   // Private so only Get() can call it.
   LocalSpanStoreImpl() {}
 
@@ -75,7 +131,10 @@ class LocalSpanStoreImpl {
   void ClearForTesting() ABSL_LOCKS_EXCLUDED(mu_);
 
   mutable absl::Mutex mu_;
-  std::deque<SpanData> spans_ ABSL_GUARDED_BY(mu_);
+  size_t max_spans_per_bucket_ ABSL_GUARDED_BY(mu_) = 10;
+  size_t max_span_names_ ABSL_GUARDED_BY(mu_) = 1024;
+  std::unordered_map<std::string, PerSpanNameSamples> samples_
+      ABSL_GUARDED_BY(mu_);
 };
 
 }  // namespace exporter
@@ -14,10 +14,18 @@
 
 #include "opencensus/trace/internal/local_span_store.h"
 
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "gtest/gtest.h"
+#include "opencensus/trace/exporter/span_exporter.h"
 #include "opencensus/trace/internal/local_span_store_impl.h"
 #include "opencensus/trace/sampler.h"
 #include "opencensus/trace/span.h"
+#include "opencensus/trace/status_code.h"
 
 namespace opencensus {
 namespace trace {
@@ -30,6 +38,11 @@ class LocalSpanStoreImplTestPeer {
   }
 };
 
+class SpanExporterTestPeer {
+ public:
+  static constexpr auto& ExportForTesting = SpanExporter::ExportForTesting;
+};
+
 namespace {
 
 TEST(LocalSpanStoreTest, GetSummary) {
@@ -38,6 +51,8 @@ TEST(LocalSpanStoreTest, GetSummary) {
   auto span = Span::StartSpan("SpanName", /*parent=*/nullptr, {&sampler});
   span.AddAnnotation("Annotation");
   span.End();
+  // The store is populated by the exporter's worker.
+  SpanExporterTestPeer::ExportForTesting();
 
   auto summary = LocalSpanStore::GetSummary();
   EXPECT_EQ(1, summary.per_span_name_summary.size());
@@ -47,6 +62,89 @@ TEST(LocalSpanStoreTest, GetSummary) {
   // number_of_latency_sampled_spans[].
 }
 
+TEST(LocalSpanStoreTest, SlowSpanIsNotEvictedByFastSpans) {
+  exporter::LocalSpanStoreImplTestPeer::ClearForTesting();
+  static AlwaysSampler sampler;
+  auto slow = Span::StartSpan("Slow", /*parent=*/nullptr, {&sampler});
+  absl::SleepFor(absl::Milliseconds(20));
+  slow.End();
+  for (int i = 0; i < 1000; ++i) {
+    Span::StartSpan("Fast", /*parent=*/nullptr, {&sampler}).End();
+  }
+  SpanExporterTestPeer::ExportForTesting();
+
+  // Under load, some of the fast spans may also take 10ms, so only look for the
+  // slow one.
+  const auto spans = LocalSpanStore::GetLatencySampledSpans(
+      {"Slow", 100, /*lower_latency_ns=*/10000000,
+       /*upper_latency_ns=*/std::numeric_limits<uint64_t>::max()});
+  ASSERT_EQ(1, spans.size());
+  EXPECT_EQ("Slow", spans[0].name());
+}
+
+TEST(LocalSpanStoreTest, ErrorSpanIsNotEvictedByOkSpans) {
+  exporter::LocalSpanStoreImplTestPeer::ClearForTesting();
+  static AlwaysSampler sampler;
+  auto failed = Span::StartSpan("Span", /*parent=*/nullptr, {&sampler});
+  failed.SetStatus(StatusCode::NOT_FOUND);
+  failed.End();
+  for (int i = 0; i < 1000; ++i) {
+    Span::StartSpan("Span", /*parent=*/nullptr, {&sampler}).End();
+  }
+  SpanExporterTestPeer::ExportForTesting();
+
+  auto spans = LocalSpanStore::GetErrorSampledSpans(
+      {"Span", 100, StatusCode::NOT_FOUND, /*all_errors=*/false});
+  ASSERT_EQ(1, spans.size());
+  EXPECT_EQ(StatusCode::NOT_FOUND, spans[0].status().CanonicalCode());
+  spans = LocalSpanStore::GetErrorSampledSpans(
+      {"", 100, StatusCode::OK, /*all_errors=*/true});
+  EXPECT_EQ(1, spans.size());
+  spans = LocalSpanStore::GetErrorSampledSpans(
+      {"Span", 100, StatusCode::OK, /*all_errors=*/false});
+  EXPECT_EQ(10, spans.size());
+}
+
+TEST(LocalSpanStoreTest, SelectSpansKeepsNewestOfEachBucket) {
+  exporter::LocalSpanStoreImplTestPeer::ClearForTesting();
+  std::vector<exporter::LocalSpanStoreImpl::SpanKey> keys;
+  for (int i = 0; i < 25; ++i) {
+    keys.push_back({"Span", absl::Microseconds(1),
+                    i == 5 ? StatusCode::NOT_FOUND : StatusCode::OK});
+  }
+  const std::vector<bool> selected =
+      exporter::LocalSpanStoreImpl::Get()->SelectSpans(keys);
+  ASSERT_EQ(keys.size(), selected.size());
+  for (int i = 0; i < 25; ++i) {
+    // The newest 10 spans fill the latency bucket and the OK bucket; the
+    // error is the only one in its bucket.
+    EXPECT_EQ(i >= 15 || i == 5, selected[i]) << i;
+  }
+}
+
+TEST(LocalSpanStoreTest, BucketsAreBounded) {
+  exporter::LocalSpanStoreImplTestPeer::ClearForTesting();
+  static AlwaysSampler sampler;
+  for (int i = 0; i < 100; ++i) {
+    Span::StartSpan("Span", /*parent=*/nullptr, {&sampler}).End();
+  }
+  SpanExporterTestPeer::ExportForTesting();
+  const LocalSpanStore::ErrorFilter ok_filter = {"Span", 100, StatusCode::OK,
+                                                 /*all_errors=*/false};
+  EXPECT_EQ(10, LocalSpanStore::GetErrorSampledSpans(ok_filter).size());
+
+  LocalSpanStore::SetMaxSpansPerBucket(3);
+  EXPECT_EQ(3, LocalSpanStore::GetErrorSampledSpans(ok_filter).size());
+  LocalSpanStore::SetMaxSpansPerBucket(10);
+
+  LocalSpanStore::SetMaxSpanNames(1);
+  Span::StartSpan("OtherSpan", /*parent=*/nullptr, {&sampler}).End();
+  SpanExporterTestPeer::ExportForTesting();
+  EXPECT_EQ(0, LocalSpanStore::GetSummary().per_span_name_summary.count(
+                   "OtherSpan"));
+  LocalSpanStore::SetMaxSpanNames(1024);
+}
+
 }  // namespace
 }  // namespace exporter
 }  // namespace trace
@@ -31,6 +31,10 @@ std::vector<SpanData> RunningSpanStore::GetRunningSpans(const Filter& filter) {
   return RunningSpanStoreImpl::Get()->GetRunningSpans(filter);
 }
 
+void RunningSpanStore::SetSamplingProbability(double probability) {
+  RunningSpanStoreImpl::Get()->SetSamplingProbability(probability);
+}
+
 }  // namespace exporter
 }  // namespace trace
 }  // namespace opencensus
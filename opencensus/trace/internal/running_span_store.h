@@ -34,6 +34,8 @@ namespace exporter {
 // long-lived operations.
 //
 // Running spans are spans that haven't called End() and are recording events.
+// By default all of them are tracked; SetSamplingProbability() can reduce or
+// remove the cost of tracking them.
 //
 // This class is thread-safe.
 class RunningSpanStore {
@@ -63,6 +65,12 @@ class RunningSpanStore {
 
   // Returns SpanData for the running spans that match the filter.
   static std::vector<SpanData> GetRunningSpans(const Filter& filter);
+
+  // Sets the fraction of recording spans that are tracked, chosen by SpanId.
+  // 0 disables tracking: starting and ending spans then skip the store
+  // entirely. Spans that are already tracked remain so until they end.
+  // Defaults to 1.
+  static void SetSamplingProbability(double probability);
 };
 
 }  // namespace exporter
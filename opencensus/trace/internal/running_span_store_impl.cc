@@ -14,6 +14,8 @@
 
 #include "opencensus/trace/internal/running_span_store_impl.h"
 
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -40,39 +42,109 @@ namespace {
 uintptr_t GetKey(const SpanImpl* span) {
   return reinterpret_cast<uintptr_t>(span);
 }
+
+// Returns the first 8 bytes of the SpanId as an integer.
+uint64_t SpanIdBits(const SpanImpl& span) {
+  uint8_t buf[SpanId::kSize];
+  span.context().span_id().CopyTo(buf);
+  uint64_t bits = 0;
+  static_assert(SpanId::kSize >= 8, "SpanId must be at least 8 bytes long.");
+  for (int i = 0; i < 8; ++i) {
+    bits |= static_cast<uint64_t>(buf[i]) << (i * 8);
+  }
+  return bits;
+}
 }  // namespace
 
+constexpr size_t RunningSpanStoreImpl::kNumShards;
+
 RunningSpanStoreImpl* RunningSpanStoreImpl::Get() {
   static RunningSpanStoreImpl* global_running_span_store =
       new RunningSpanStoreImpl;
   return global_running_span_store;
 }
 
-void RunningSpanStoreImpl::AddSpan(const std::shared_ptr<SpanImpl>& span) {
-  absl::MutexLock l(&mu_);
-  spans_.insert({GetKey(span.get()), span});
+RunningSpanStoreImpl::Shard& RunningSpanStoreImpl::GetShard(uintptr_t key) {
+  // Allocations are aligned, so mix in the higher bits.
+  return shards_[((key >> 4) ^ (key >> 12)) % kNumShards];
+}
+
+void RunningSpanStoreImpl::AddSpan(const SpanImplPtr& span) {
+  const uint64_t threshold = threshold_.load(std::memory_order_relaxed);
+  if (threshold != UINT64_MAX &&
+      (threshold == 0 || SpanIdBits(*span) >= threshold)) {
+    return;
+  }
+  std::string name = span->name();
+  const uintptr_t key = GetKey(span.get());
+  Shard& shard = GetShard(key);
+  absl::MutexLock l(&shard.mu);
+  auto inserted = shard.spans.insert({key, Entry{span, nullptr}});
+  if (inserted.second) {
+    inserted.first->second.name = shard.IncrementName(std::move(name));
+    shard.size.store(shard.spans.size(), std::memory_order_relaxed);
+  }
 }
 
-bool RunningSpanStoreImpl::RemoveSpan(const std::shared_ptr<SpanImpl>& span) {
-  absl::MutexLock l(&mu_);
-  auto iter = spans_.find(GetKey(span.get()));
-  if (iter == spans_.end()) {
+bool RunningSpanStoreImpl::RemoveSpan(const SpanImplPtr& span) {
+  const uintptr_t key = GetKey(span.get());
+  Shard& shard = GetShard(key);
+  // A tracked span was added by a thread that happens-before this one, so a
+  // shard holding it cannot look empty.
+  if (shard.size.load(std::memory_order_relaxed) == 0) {
+    return false;
+  }
+  absl::MutexLock l(&shard.mu);
+  auto iter = shard.spans.find(key);
+  if (iter == shard.spans.end()) {
     return false;  // Not tracked.
   }
-  spans_.erase(iter);
+  shard.DecrementName(iter->second.name);
+  shard.spans.erase(iter);
+  shard.size.store(shard.spans.size(), std::memory_order_relaxed);
   return true;
 }
 
+void RunningSpanStoreImpl::RenameSpan(const SpanImplPtr& span) {
+  const uintptr_t key = GetKey(span.get());
+  Shard& shard = GetShard(key);
+  absl::MutexLock l(&shard.mu);
+  auto iter = shard.spans.find(key);
+  if (iter == shard.spans.end()) {
+    return;  // Not tracked.
+  }
+  // Read the name under the shard's mutex so that concurrent renames leave the
+  // count under the Span's final name.
+  std::string name = span->name();
+  if (name == iter->second.name->first) {
+    return;
+  }
+  shard.DecrementName(iter->second.name);
+  iter->second.name = shard.IncrementName(std::move(name));
+}
+
+RunningSpanStoreImpl::NameCounts::value_type*
+RunningSpanStoreImpl::Shard::IncrementName(std::string name) {
+  auto& name_count = *name_counts.insert({std::move(name), 0}).first;
+  ++name_count.second;
+  return &name_count;
+}
+
+void RunningSpanStoreImpl::Shard::DecrementName(
+    NameCounts::value_type* name) {
+  if (--name->second == 0) {
+    // Erase by iterator: the key argument would refer into the erased node.
+    name_counts.erase(name_counts.find(name->first));
+  }
+}
+
 RunningSpanStore::Summary RunningSpanStoreImpl::GetSummary() const {
   RunningSpanStore::Summary summary;
-  absl::MutexLock l(&mu_);
-  for (const auto& addr_span : spans_) {
-    const std::string name = addr_span.second->name();
-    auto it = summary.per_span_name_summary.find(name);
-    if (it != summary.per_span_name_summary.end()) {
-      it->second.num_running_spans++;
-    } else {
-      summary.per_span_name_summary[name] = {1};
+  for (const Shard& shard : shards_) {
+    absl::MutexLock l(&shard.mu);
+    for (const auto& name_count : shard.name_counts) {
+      summary.per_span_name_summary[name_count.first].num_running_spans +=
+          name_count.second;
     }
   }
   return summary;
@@ -81,19 +153,48 @@ RunningSpanStore::Summary RunningSpanStoreImpl::GetSummary() const {
 std::vector<SpanData> RunningSpanStoreImpl::GetRunningSpans(
     const RunningSpanStore::Filter& filter) const {
   std::vector<SpanData> running_spans;
-  absl::MutexLock l(&mu_);
-  for (const auto& it : spans_) {
-    if (running_spans.size() >= filter.max_spans_to_return) break;
-    if (filter.span_name.empty() || (it.second->name() == filter.span_name)) {
-      running_spans.emplace_back(it.second->ToSpanData());
+  for (const Shard& shard : shards_) {
+    absl::MutexLock l(&shard.mu);
+    const NameCounts::value_type* name = nullptr;
+    if (!filter.span_name.empty()) {
+      auto it = shard.name_counts.find(filter.span_name);
+      if (it == shard.name_counts.end()) {
+        continue;
+      }
+      name = &*it;
+    }
+    for (const auto& it : shard.spans) {
+      if (running_spans.size() >= filter.max_spans_to_return) {
+        return running_spans;
+      }
+      if (name == nullptr || it.second.name == name) {
+        running_spans.emplace_back(it.second.span->ToSpanData());
+      }
     }
   }
   return running_spans;
 }
 
+void RunningSpanStoreImpl::SetSamplingProbability(double probability) {
+  uint64_t threshold;
+  if (probability <= 0.0) {
+    threshold = 0;
+  } else if (probability >= 1.0) {
+    threshold = UINT64_MAX;
+  } else {
+    // probability < 1, so the product is below 2^64.
+    threshold = static_cast<uint64_t>(std::ldexp(probability, 64));
+  }
+  threshold_.store(threshold, std::memory_order_relaxed);
+}
+
 void RunningSpanStoreImpl::ClearForTesting() {
-  absl::MutexLock l(&mu_);
-  spans_.clear();
+  for (Shard& shard : shards_) {
+    absl::MutexLock l(&shard.mu);
+    shard.spans.clear();
+    shard.name_counts.clear();
+    shard.size.store(0, std::memory_order_relaxed);
+  }
 }
 
 }  // namespace exporter
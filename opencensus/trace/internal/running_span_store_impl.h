@@ -15,15 +15,20 @@
 #ifndef OPENCENSUS_TRACE_INTERNAL_RUNNING_SPAN_STORE_IMPL_H_
 #define OPENCENSUS_TRACE_INTERNAL_RUNNING_SPAN_STORE_IMPL_H_
 
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
-#include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "absl/base/optimization.h"
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
 #include "opencensus/trace/internal/running_span_store.h"
 #include "opencensus/trace/internal/span_impl.h"
+#include "opencensus/trace/span_impl_ptr.h"
 
 namespace opencensus {
 namespace trace {
@@ -37,34 +42,72 @@ class RunningSpanStoreImpl {
   // Returns the global instance of RunningSpanStoreImpl.
   static RunningSpanStoreImpl* Get();
 
-  // Adds a new running Span.
-  void AddSpan(const std::shared_ptr<SpanImpl>& span) ABSL_LOCKS_EXCLUDED(mu_);
+  // Adds a new running Span, if it is selected by the sampling probability.
+  void AddSpan(const SpanImplPtr& span);
 
   // Removes a Span that's no longer running. Returns true on success, false if
   // that Span was not being tracked.
-  bool RemoveSpan(const std::shared_ptr<SpanImpl>& span)
-      ABSL_LOCKS_EXCLUDED(mu_);
+  bool RemoveSpan(const SpanImplPtr& span);
 
-  // Returns a summary of the data available in the RunningSpanStore.
-  RunningSpanStore::Summary GetSummary() const ABSL_LOCKS_EXCLUDED(mu_);
+  // Updates the summary after the Span's name changed. Does nothing if the Span
+  // is not being tracked.
+  void RenameSpan(const SpanImplPtr& span);
+
+  // Returns a summary of the data available in the RunningSpanStore. This is
+  // O(number of span names), not O(number of spans).
+  RunningSpanStore::Summary GetSummary() const;
 
   // Returns the running spans that match the filter.
   std::vector<SpanData> GetRunningSpans(
-      const RunningSpanStore::Filter& filter) const ABSL_LOCKS_EXCLUDED(mu_);
+      const RunningSpanStore::Filter& filter) const;
+
+  void SetSamplingProbability(double probability);
 
  private:
   friend class RunningSpanStoreImplTestPeer;
 
+  // Spans are spread over shards by address so that concurrent starts and
+  // ends rarely contend on the same mutex.
+  static constexpr size_t kNumShards = 16;
+
+  // The number of running spans with each name.
+  using NameCounts = std::unordered_map<std::string, int>;
+
+  struct Entry {
+    SpanImplPtr span;
+    // The element of the shard's name_counts that counts this span. Elements
+    // are erased only when their count drops to zero, so this stays valid.
+    NameCounts::value_type* name;
+  };
+
+  struct Shard {
+    NameCounts::value_type* IncrementName(std::string name)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu);
+    void DecrementName(NameCounts::value_type* name)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu);
+
+    mutable absl::Mutex mu;
+    // The key is the memory address of the underlying SpanImpl object.
+    std::unordered_map<uintptr_t, Entry> spans ABSL_GUARDED_BY(mu);
+    NameCounts name_counts ABSL_GUARDED_BY(mu);
+    // spans.size(), readable without mu so that ending an untracked span can
+    // usually skip the lock.
+    std::atomic<size_t> size{0};
+    // Keeps neighbouring shards' mutexes off this cache line.
+    char pad[ABSL_CACHELINE_SIZE];
+  };
+
   RunningSpanStoreImpl() {}
 
-  // Clears all currently active spans from the store.
-  void ClearForTesting() ABSL_LOCKS_EXCLUDED(mu_);
+  Shard& GetShard(uintptr_t key);
 
-  mutable absl::Mutex mu_;
+  // Clears all currently active spans from the store.
+  void ClearForTesting();
 
-  // The key is the memory address of the underlying SpanImpl object.
-  std::unordered_map<uintptr_t, std::shared_ptr<SpanImpl>> spans_
-      ABSL_GUARDED_BY(mu_);
+  // Spans whose SpanId, read as an integer, is below the threshold are tracked.
+  // 0 disables tracking, UINT64_MAX tracks all spans.
+  std::atomic<uint64_t> threshold_{UINT64_MAX};
+  std::array<Shard, kNumShards> shards_;
 };
 
 }  // namespace exporter
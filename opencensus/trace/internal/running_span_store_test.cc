@@ -104,6 +104,49 @@ TEST(RunningSpanStoreTest, GetSummaryAndGetRunningSpans) {
   EXPECT_EQ(1, summary.per_span_name_summary["Group2"].num_running_spans);
 }
 
+TEST(RunningSpanStoreTest, SummaryFollowsRename) {
+  AlwaysSampler sampler;
+  RunningSpanStoreImplTestPeer::ClearForTesting();
+  auto span = Span::StartSpan("OldName", nullptr, {&sampler});
+  span.SetName("NewName");
+
+  auto summary = RunningSpanStore::GetSummary();
+  EXPECT_EQ(0, summary.per_span_name_summary.count("OldName"));
+  EXPECT_EQ(1, summary.per_span_name_summary["NewName"].num_running_spans);
+  EXPECT_EQ(1, RunningSpanStore::GetRunningSpans({"NewName", 10}).size());
+
+  span.End();
+  summary = RunningSpanStore::GetSummary();
+  EXPECT_TRUE(summary.per_span_name_summary.empty());
+}
+
+TEST(RunningSpanStoreTest, SamplingProbability) {
+  AlwaysSampler sampler;
+  RunningSpanStoreImplTestPeer::ClearForTesting();
+  auto tracked = Span::StartSpan("Tracked", nullptr, {&sampler});
+  RunningSpanStore::SetSamplingProbability(0.0);
+  auto untracked = Span::StartSpan("Untracked", nullptr, {&sampler});
+  EXPECT_EQ(1, RunningSpanStore::GetRunningSpans({"", 10}).size());
+  // Spans tracked before tracking was disabled are still removed on End().
+  tracked.End();
+  untracked.End();
+  EXPECT_EQ(0, RunningSpanStore::GetRunningSpans({"", 10}).size());
+
+  RunningSpanStore::SetSamplingProbability(0.5);
+  std::vector<Span> spans;
+  for (int i = 0; i < 1000; ++i) {
+    spans.push_back(Span::StartSpan("Span", nullptr, {&sampler}));
+  }
+  const int num_tracked =
+      RunningSpanStore::GetSummary().per_span_name_summary["Span"]
+          .num_running_spans;
+  EXPECT_GT(num_tracked, 350);
+  EXPECT_LT(num_tracked, 650);
+  for (auto& span : spans) span.End();
+  EXPECT_TRUE(RunningSpanStore::GetSummary().per_span_name_summary.empty());
+  RunningSpanStore::SetSamplingProbability(1.0);
+}
+
 }  // namespace
 }  // namespace exporter
 }  // namespace trace
@@ -14,10 +14,14 @@
 
 #include "opencensus/trace/sampler.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 
 #include "absl/base/attributes.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 
 namespace opencensus {
 namespace trace {
@@ -48,6 +52,11 @@ uint64_t CalculateThresholdFromBuffer(const TraceId& trace_id) {
   }
   return res;
 }
+
+// Returns true for root spans, including those with a remote parent.
+bool IsRoot(const SpanContext* parent_context, bool has_remote_parent) {
+  return parent_context == nullptr || has_remote_parent;
+}
 }  // namespace
 
 ProbabilitySampler::ProbabilitySampler(double probability)
@@ -65,5 +74,91 @@ bool ProbabilitySampler::ShouldSample(
   return CalculateThresholdFromBuffer(trace_id) <= threshold_;
 }
 
+RateLimitingSampler::RateLimitingSampler(double max_per_second)
+    : interval_nanos_(max_per_second > 0
+                          ? std::max<int64_t>(
+                                1, static_cast<int64_t>(1e9 / max_per_second))
+                          : 0),
+      burst_nanos_(absl::ToInt64Nanoseconds(absl::Seconds(1))),
+      empty_time_nanos_(0) {}
+
+bool RateLimitingSampler::ShouldSample(
+    const SpanContext* parent_context, bool has_remote_parent,
+    const TraceId& trace_id ABSL_ATTRIBUTE_UNUSED,
+    const SpanId& span_id ABSL_ATTRIBUTE_UNUSED,
+    absl::string_view name ABSL_ATTRIBUTE_UNUSED,
+    const std::vector<Span*>& parent_links ABSL_ATTRIBUTE_UNUSED) const {
+  if (interval_nanos_ == 0 || !IsRoot(parent_context, has_remote_parent)) {
+    return false;
+  }
+  const int64_t now = absl::GetCurrentTimeNanos();
+  int64_t empty_time = empty_time_nanos_.load(std::memory_order_relaxed);
+  while (true) {
+    // A bucket that has been full for a while holds no more than a burst.
+    const int64_t start = std::max(empty_time, now - burst_nanos_);
+    if (start > now) return false;
+    if (empty_time_nanos_.compare_exchange_weak(empty_time,
+                                                start + interval_nanos_,
+                                                std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+}
+
+AdaptiveSampler::AdaptiveSampler(double target_per_second,
+                                 absl::Duration window)
+    : target_per_window_(std::max(0.0, target_per_second) *
+                         absl::ToDoubleSeconds(window)),
+      window_nanos_(std::max<int64_t>(1, absl::ToInt64Nanoseconds(window))),
+      max_per_window_(static_cast<uint64_t>(std::ceil(2 * target_per_window_))),
+      window_end_nanos_(absl::GetCurrentTimeNanos() + window_nanos_),
+      seen_(0),
+      sampled_(0),
+      threshold_(target_per_window_ > 0 ? UINT64_MAX : 0) {}
+
+bool AdaptiveSampler::ShouldSample(
+    const SpanContext* parent_context, bool has_remote_parent,
+    const TraceId& trace_id, const SpanId& span_id ABSL_ATTRIBUTE_UNUSED,
+    absl::string_view name ABSL_ATTRIBUTE_UNUSED,
+    const std::vector<Span*>& parent_links ABSL_ATTRIBUTE_UNUSED) const {
+  if (!IsRoot(parent_context, has_remote_parent)) return false;
+  MaybeAdjust(absl::GetCurrentTimeNanos());
+  seen_.fetch_add(1, std::memory_order_relaxed);
+  const uint64_t threshold = threshold_.load(std::memory_order_relaxed);
+  if (threshold == 0 || CalculateThresholdFromBuffer(trace_id) > threshold) {
+    return false;
+  }
+  return sampled_.fetch_add(1, std::memory_order_relaxed) < max_per_window_;
+}
+
+double AdaptiveSampler::probability() const {
+  return ldexp(static_cast<double>(threshold_.load(std::memory_order_relaxed)),
+               -64);
+}
+
+void AdaptiveSampler::MaybeAdjust(int64_t now_nanos) const {
+  int64_t window_end = window_end_nanos_.load(std::memory_order_relaxed);
+  if (now_nanos < window_end) return;
+  // Only the thread that moves the window on adjusts the probability.
+  if (!window_end_nanos_.compare_exchange_strong(window_end,
+                                                 now_nanos + window_nanos_,
+                                                 std::memory_order_relaxed)) {
+    return;
+  }
+  const uint64_t seen = seen_.exchange(0, std::memory_order_relaxed);
+  sampled_.store(0, std::memory_order_relaxed);
+  if (target_per_window_ <= 0) return;
+  // The window may have been extended by a period with no spans at all.
+  const double elapsed_windows =
+      static_cast<double>(now_nanos - window_end + window_nanos_) /
+      window_nanos_;
+  const double seen_per_window = seen / elapsed_windows;
+  threshold_.store(seen_per_window <= target_per_window_
+                       ? UINT64_MAX
+                       : CalculateThreshold(target_per_window_ /
+                                            seen_per_window),
+                   std::memory_order_relaxed);
+}
+
 }  // namespace trace
 }  // namespace opencensus
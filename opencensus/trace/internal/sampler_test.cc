@@ -70,6 +70,55 @@ TEST(SamplerTest, SampleNth) {
   }
 }
 
+TEST(SamplerTest, RateLimitingSamplerCapsRootSpans) {
+  RateLimitingSampler sampler(10);
+  int sampled = 0;
+  for (int i = 0; i < 1000; ++i) {
+    if (sampler.ShouldSample(nullptr, false, TraceId(), SpanId(), "MySpan",
+                             {})) {
+      ++sampled;
+    }
+  }
+  // One second's burst, and perhaps a token that was refilled meanwhile.
+  EXPECT_GE(sampled, 10);
+  EXPECT_LE(sampled, 11);
+
+  // Refills over time.
+  absl::SleepFor(absl::Milliseconds(250));
+  EXPECT_TRUE(
+      sampler.ShouldSample(nullptr, false, TraceId(), SpanId(), "MySpan", {}));
+}
+
+TEST(SamplerTest, RateLimitingSamplerOnlySamplesRoots) {
+  RateLimitingSampler sampler(1000);
+  const SpanContext parent;
+  EXPECT_FALSE(sampler.ShouldSample(&parent, /*has_remote_parent=*/false,
+                                    TraceId(), SpanId(), "MySpan", {}));
+  EXPECT_TRUE(sampler.ShouldSample(&parent, /*has_remote_parent=*/true,
+                                   TraceId(), SpanId(), "MySpan", {}));
+  RateLimitingSampler never(0);
+  EXPECT_FALSE(
+      never.ShouldSample(nullptr, false, TraceId(), SpanId(), "MySpan", {}));
+}
+
+TEST(SamplerTest, AdaptiveSamplerTracksTarget) {
+  // 10 spans per 10ms window.
+  AdaptiveSampler sampler(1000, absl::Milliseconds(10));
+  EXPECT_EQ(1.0, sampler.probability());
+  int sampled = 0;
+  const absl::Time start = absl::Now();
+  while (absl::Now() - start < absl::Milliseconds(200)) {
+    for (int i = 0; i < 100; ++i) {
+      auto span = Span::StartSpan("MySpan", nullptr, {&sampler});
+      if (span.IsSampled()) ++sampled;
+    }
+  }
+  EXPECT_GT(sampled, 0);
+  // At most twice the target per window.
+  EXPECT_LE(sampled, 20 * 22);
+  EXPECT_LT(sampler.probability(), 1.0);
+}
+
 }  // namespace
 }  // namespace trace
 }  // namespace opencensus
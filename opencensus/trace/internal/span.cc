@@ -13,10 +13,11 @@
 // limitations under the License.
 
 #include <cstdint>
-#include <memory>
+#include <cstring>
 #include <string>
 #include <utility>
 
+#include "absl/base/attributes.h"
 #include "absl/strings/string_view.h"
 #include "opencensus/common/internal/random.h"
 #include "opencensus/trace/exporter/annotation.h"
@@ -24,11 +25,12 @@
 #include "opencensus/trace/exporter/link.h"
 #include "opencensus/trace/exporter/message_event.h"
 #include "opencensus/trace/exporter/status.h"
-#include "opencensus/trace/internal/local_span_store_impl.h"
 #include "opencensus/trace/internal/running_span_store.h"
 #include "opencensus/trace/internal/running_span_store_impl.h"
+#include "opencensus/trace/internal/span_counts.h"
 #include "opencensus/trace/internal/span_exporter_impl.h"
 #include "opencensus/trace/internal/span_impl.h"
+#include "opencensus/trace/internal/tail_sampling_buffer.h"
 #include "opencensus/trace/internal/trace_config_impl.h"
 #include "opencensus/trace/sampler.h"
 #include "opencensus/trace/span.h"
@@ -41,6 +43,11 @@
 
 namespace opencensus {
 namespace trace {
+
+// With OPENCENSUS_DISABLE_INSTRUMENTATION, Span is implemented inline in
+// span.h.
+#ifndef OPENCENSUS_DISABLE_INSTRUMENTATION
+
 namespace {
 
 // Generates a random SpanId.
@@ -59,6 +66,40 @@ TraceId GenerateRandomTraceId() {
   return TraceId(trace_id_buf);
 }
 
+// Derives a SpanId for a span that will not be recorded from 'seed', which is
+// the parent's SpanId, or part of the TraceId for a root span. Such a span only
+// carries context for propagation, so its SpanId needs to be unlikely to
+// collide within the trace, but not to be random: seed is mixed with a
+// per-thread sequence (splitmix64) instead of drawing from the Random
+// generator.
+SpanId DeriveSpanId(const uint8_t* seed) {
+  static thread_local uint64_t sequence =
+      ::opencensus::common::Random::GetRandom()->GenerateRandom64();
+  uint64_t z;
+  memcpy(&z, seed, sizeof(z));
+  z ^= (sequence += 0x9e3779b97f4a7c15);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+  z ^= z >> 31;
+  if (z == 0) z = 1;  // An all-zero SpanId is invalid.
+  uint8_t span_id_buf[SpanId::kSize];
+  memcpy(span_id_buf, &z, sizeof(z));
+  return SpanId(span_id_buf);
+}
+
+// Returns true if a span that is not sampled by its parent can skip the
+// Sampler and will not be recorded. This holds when nothing can record it (tail
+// sampling is off), the span has no options that need the slow path, and
+// either its parent is local, in which case the parent's decision is kept, or
+// the default Sampler never samples.
+bool SkipsSampling(const SpanContext* parent_ctx, bool has_remote_parent,
+                   const StartSpanOptions& options) {
+  return options.sampler == nullptr && options.parent_links.empty() &&
+         !exporter::TailSamplingBuffer::Get()->enabled() &&
+         ((parent_ctx != nullptr && !has_remote_parent) ||
+          TraceConfigImpl::Get()->NeverSamples());
+}
+
 }  // namespace
 
 class SpanGenerator {
@@ -66,7 +107,41 @@ class SpanGenerator {
   static Span Generate(absl::string_view name, const SpanContext* parent_ctx,
                        bool has_remote_parent,
                        const StartSpanOptions& options) {
-    SpanId span_id = GenerateRandomSpanId();
+    if ((parent_ctx == nullptr || !parent_ctx->trace_options().IsSampled()) &&
+        SkipsSampling(parent_ctx, has_remote_parent, options)) {
+      // Fast path: the span only carries context, so it needs no random
+      // SpanId, no sampling decision and no SpanImpl.
+      if (parent_ctx == nullptr) {
+        const TraceId trace_id = GenerateRandomTraceId();
+        return Unrecorded(
+            SpanContext(trace_id,
+                        DeriveSpanId(
+                            static_cast<const uint8_t*>(trace_id.Value()))),
+            name);
+      }
+      return Unrecorded(SpanContext(parent_ctx->trace_id(),
+                                    DeriveSpanId(static_cast<const uint8_t*>(
+                                        parent_ctx->span_id().Value())),
+                                    parent_ctx->trace_options()),
+                        name);
+    }
+    return GenerateSlow(name, parent_ctx, has_remote_parent, options);
+  }
+
+ private:
+  // Returns a Span without a SpanImpl, counted by SpanCounts if enabled.
+  static Span Unrecorded(const SpanContext& context, absl::string_view name) {
+    Span span(context, nullptr);
+    if (SpanCounts::Get()->enabled()) {
+      span.counted_span_ = CountedSpan::Create(name);
+    }
+    return span;
+  }
+
+  // Kept out of line so that the fast path stays small.
+  ABSL_ATTRIBUTE_NOINLINE static Span GenerateSlow(
+      absl::string_view name, const SpanContext* parent_ctx,
+      bool has_remote_parent, const StartSpanOptions& options) {
     TraceId trace_id;
     SpanId parent_span_id;
     TraceOptions trace_options;
@@ -77,12 +152,16 @@ class SpanGenerator {
       parent_span_id = parent_ctx->span_id();
       trace_options = parent_ctx->trace_options();
     }
+    SpanId span_id = GenerateRandomSpanId();
     if (!trace_options.IsSampled()) {
       bool should_sample = false;
-      if (options.sampler != nullptr) {
-        should_sample = options.sampler->ShouldSample(
-            parent_ctx, has_remote_parent, trace_id, span_id, name,
-            options.parent_links);
+      const Sampler* sampler = options.sampler != nullptr
+                                   ? options.sampler
+                                   : TraceConfigImpl::Get()->sampler();
+      if (sampler != nullptr) {
+        should_sample =
+            sampler->ShouldSample(parent_ctx, has_remote_parent, trace_id,
+                                  span_id, name, options.parent_links);
       } else {
         should_sample =
             TraceConfigImpl::Get()->current_trace_params().sampler.ShouldSample(
@@ -92,12 +171,14 @@ class SpanGenerator {
       trace_options = trace_options.WithSampling(should_sample);
     }
     SpanContext context(trace_id, span_id, trace_options);
-    SpanImpl* impl = nullptr;
-    if (trace_options.IsSampled()) {
-      // Only Spans that are sampled are backed by a SpanImpl.
-      impl =
-          new SpanImpl(context, TraceConfigImpl::Get()->current_trace_params(),
-                       name, parent_span_id, has_remote_parent);
+    SpanImplPtr impl;
+    if (trace_options.IsSampled() ||
+        exporter::TailSamplingBuffer::Get()->enabled()) {
+      // Only Spans that are sampled, or may be kept by tail sampling, are
+      // backed by a SpanImpl.
+      impl = SpanImpl::Create(context,
+                              TraceConfigImpl::Get()->current_trace_params(),
+                              name, parent_span_id, has_remote_parent);
     }
     // Add links.
     for (const auto& parent_link : options.parent_links) {
@@ -108,7 +189,10 @@ class SpanGenerator {
       }
       parent_link->AddChildLink(context);
     }
-    return Span(context, impl);
+    if (impl == nullptr) {
+      return Unrecorded(context, name);
+    }
+    return Span(context, std::move(impl));
   }
 };
 
@@ -132,8 +216,8 @@ Span Span::StartSpanWithRemoteParent(absl::string_view name,
                                  /*has_remote_parent=*/true, options);
 }
 
-Span::Span(const SpanContext& context, SpanImpl* impl)
-    : context_(context), span_impl_(impl) {
+Span::Span(const SpanContext& context, SpanImplPtr impl)
+    : context_(context), span_impl_(std::move(impl)) {
   if (IsRecording()) {
     exporter::RunningSpanStoreImpl::Get()->AddSpan(span_impl_);
   }
@@ -199,24 +283,42 @@ void Span::SetStatus(StatusCode canonical_code,
                      absl::string_view message) const {
   if (IsRecording()) {
     span_impl_->SetStatus(exporter::Status(canonical_code, message));
+  } else if (counted_span_ != nullptr) {
+    counted_span_->SetStatus(canonical_code);
   }
 }
 
 void Span::SetName(absl::string_view name) const {
   if (IsRecording()) {
     span_impl_->SetName(name);
+    exporter::RunningSpanStoreImpl::Get()->RenameSpan(span_impl_);
+  } else if (counted_span_ != nullptr) {
+    counted_span_->SetName(name);
   }
 }
 
 void Span::End() const {
+  if (counted_span_ != nullptr) {
+    counted_span_->End();
+  }
   if (IsRecording()) {
-    if (!span_impl_->End()) {
+    SpanCounts* counts = SpanCounts::Get();
+    SpanImpl::EndedSpan ended;
+    const bool count = counts->enabled();
+    if (!span_impl_->End(count ? &ended : nullptr)) {
       // The Span already ended, ignore this call.
       return;
     }
+    if (count) {
+      SpanCounts::Add(counts->GetCounter(ended.name), ended.status_code,
+                      ended.latency_ticks);
+    }
     exporter::RunningSpanStoreImpl::Get()->RemoveSpan(span_impl_);
-    exporter::LocalSpanStoreImpl::Get()->AddSpan(span_impl_);
-    exporter::SpanExporterImpl::Get()->AddSpan(span_impl_);
+    if (IsSampled()) {
+      exporter::SpanExporterImpl::Get()->AddSpan(span_impl_);
+    } else {
+      exporter::TailSamplingBuffer::Get()->AddSpan(span_impl_);
+    }
   }
 }
 
@@ -226,10 +328,13 @@ bool Span::IsSampled() const { return context_.trace_options().IsSampled(); }
 
 bool Span::IsRecording() const { return span_impl_ != nullptr; }
 
+#endif  // OPENCENSUS_DISABLE_INSTRUMENTATION
+
 void swap(Span& a, Span& b) {
   using std::swap;
   swap(a.context_, b.context_);
   swap(a.span_impl_, b.span_impl_);
+  swap(a.counted_span_, b.counted_span_);
 }
 
 }  // namespace trace
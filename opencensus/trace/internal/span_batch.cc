@@ -0,0 +1,120 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/exporter/span_batch.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "absl/hash/hash.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "opencensus/common/internal/arena.h"
+#include "opencensus/trace/attribute_value_ref.h"
+#include "opencensus/trace/internal/attribute_list.h"
+#include "opencensus/trace/static_string.h"
+
+namespace opencensus {
+namespace trace {
+namespace exporter {
+
+struct SpanBatch::StringStorage {
+  common::Arena arena;
+  std::unordered_map<absl::string_view, StringIndex,
+                     absl::Hash<absl::string_view>>
+      indexes;
+};
+
+SpanBatch::SpanBatch() = default;
+SpanBatch::~SpanBatch() = default;
+SpanBatch::SpanBatch(SpanBatch&&) = default;
+SpanBatch& SpanBatch::operator=(SpanBatch&&) = default;
+
+SpanBatch::StringIndex SpanBatch::AddString(absl::string_view s,
+                                            bool is_static) {
+  if (string_storage_ == nullptr) {
+    string_storage_ = absl::make_unique<StringStorage>();
+  }
+  auto it = string_storage_->indexes.find(s);
+  if (it != string_storage_->indexes.end()) return it->second;
+  // The key must outlive the caller's string, so it is the copy.
+  const absl::string_view copy = is_static || StaticString::IsInterned(s)
+                                     ? s
+                                     : string_storage_->arena.CopyString(s);
+  const StringIndex index = static_cast<StringIndex>(strings_.size());
+  strings_.push_back(copy);
+  string_storage_->indexes.emplace(copy, index);
+  return index;
+}
+
+SpanBatch::Range SpanBatch::AddAttributes(
+    absl::Span<const ArenaAttribute> attributes) {
+  Range range;
+  range.begin = static_cast<uint32_t>(attributes_.size());
+  for (const ArenaAttribute& attribute : attributes) {
+    Attribute column;
+    column.key = AddString(attribute.key);
+    column.type = attribute.value.type();
+    switch (column.type) {
+      case AttributeValueRef::Type::kString:
+        column.value = AddString(attribute.value.string_value(),
+                                 attribute.value.has_static_storage());
+        break;
+      case AttributeValueRef::Type::kBool:
+        column.value = attribute.value.bool_value() ? 1 : 0;
+        break;
+      case AttributeValueRef::Type::kInt:
+        column.value = attribute.value.int_value();
+        break;
+    }
+    attributes_.push_back(column);
+  }
+  range.end = static_cast<uint32_t>(attributes_.size());
+  return range;
+}
+
+void SpanBatch::Reserve(size_t n) {
+  n += size();
+  trace_ids_.reserve(n);
+  span_ids_.reserve(n);
+  trace_options_.reserve(n);
+  parent_span_ids_.reserve(n);
+  has_remote_parent_.reserve(n);
+  names_.reserve(n);
+  start_times_.reserve(n);
+  end_times_.reserve(n);
+  status_codes_.reserve(n);
+  status_messages_.reserve(n);
+  attribute_ranges_.reserve(n);
+  annotation_ranges_.reserve(n);
+  message_event_ranges_.reserve(n);
+  link_ranges_.reserve(n);
+  num_attributes_dropped_.reserve(n);
+  num_annotations_dropped_.reserve(n);
+  num_message_events_dropped_.reserve(n);
+  num_links_dropped_.reserve(n);
+}
+
+void SpanBatch::FinishBuilding() {
+  if (string_storage_ != nullptr) {
+    decltype(string_storage_->indexes)().swap(string_storage_->indexes);
+  }
+}
+
+}  // namespace exporter
+}  // namespace trace
+}  // namespace opencensus
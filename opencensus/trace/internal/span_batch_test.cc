@@ -0,0 +1,305 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/exporter/span_batch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "opencensus/trace/exporter/span_data.h"
+#include "opencensus/trace/exporter/span_exporter.h"
+#include "opencensus/trace/sampler.h"
+#include "opencensus/trace/span.h"
+#include "opencensus/trace/static_string.h"
+#include "opencensus/trace/status_code.h"
+
+namespace opencensus {
+namespace trace {
+
+namespace exporter {
+class SpanExporterTestPeer {
+ public:
+  static constexpr auto& ExportForTesting = SpanExporter::ExportForTesting;
+};
+}  // namespace exporter
+
+namespace {
+
+// A span read back from a SpanBatch.
+struct BatchSpan {
+  std::string name;
+  SpanId span_id;
+  SpanId parent_span_id;
+  int64_t start_time;
+  int64_t end_time;
+  StatusCode status_code;
+  std::string status_message;
+  // "key=value" for each attribute.
+  std::vector<std::string> attributes;
+  // "description: key=value ..." for each annotation.
+  std::vector<std::string> annotations;
+  std::vector<uint32_t> message_event_ids;
+  std::vector<SpanId> link_span_ids;
+  uint32_t num_attributes_dropped;
+};
+
+std::string AttributeToString(const exporter::SpanBatch& batch,
+                              const exporter::SpanBatch::Attribute& attr) {
+  std::string value;
+  switch (attr.type) {
+    case AttributeValueRef::Type::kString:
+      value = std::string(batch.string(attr.value));
+      break;
+    case AttributeValueRef::Type::kBool:
+      value = attr.value != 0 ? "true" : "false";
+      break;
+    case AttributeValueRef::Type::kInt:
+      value = std::to_string(attr.value);
+      break;
+  }
+  return std::string(batch.string(attr.key)) + "=" + value;
+}
+
+std::vector<std::string> AttributesToStrings(
+    const exporter::SpanBatch& batch, exporter::SpanBatch::Range range) {
+  std::vector<std::string> attributes;
+  for (uint32_t i = range.begin; i < range.end; ++i) {
+    attributes.push_back(AttributeToString(batch, batch.attributes()[i]));
+  }
+  std::sort(attributes.begin(), attributes.end());
+  return attributes;
+}
+
+// Records the spans and string tables of exported batches.
+class BatchRecorder : public exporter::SpanExporter::BatchHandler {
+ public:
+  static std::vector<BatchSpan> TakeSpans() {
+    exporter::SpanExporterTestPeer::ExportForTesting();
+    absl::MutexLock l(&mu_);
+    std::vector<BatchSpan> spans;
+    spans.swap(*spans_);
+    return spans;
+  }
+
+  // Returns the number of times s appeared in the string tables since the
+  // last call to TakeSpans().
+  static int CountString(absl::string_view s) {
+    absl::MutexLock l(&mu_);
+    return static_cast<int>(std::count(strings_->begin(), strings_->end(), s));
+  }
+
+  // Returns the address of s in the string tables, or nullptr.
+  static const char* StringData(absl::string_view s) {
+    absl::MutexLock l(&mu_);
+    for (const auto& pair : *string_data_) {
+      if (pair.first == s) return pair.second;
+    }
+    return nullptr;
+  }
+
+  static void ClearStrings() {
+    absl::MutexLock l(&mu_);
+    strings_->clear();
+    string_data_->clear();
+  }
+
+  void Export(const exporter::SpanBatch& batch) override {
+    absl::MutexLock l(&mu_);
+    for (absl::string_view s : batch.strings()) {
+      strings_->emplace_back(s);
+      string_data_->emplace_back(std::string(s), s.data());
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+      BatchSpan span;
+      span.name = std::string(batch.string(batch.names()[i]));
+      span.span_id = batch.span_ids()[i];
+      span.parent_span_id = batch.parent_span_ids()[i];
+      span.start_time = batch.start_times()[i];
+      span.end_time = batch.end_times()[i];
+      span.status_code = batch.status_codes()[i];
+      span.status_message =
+          std::string(batch.string(batch.status_messages()[i]));
+      span.attributes = AttributesToStrings(batch, batch.attribute_ranges()[i]);
+      const auto annotations = batch.annotation_ranges()[i];
+      for (uint32_t j = annotations.begin; j < annotations.end; ++j) {
+        const auto& annotation = batch.annotations()[j];
+        std::string s = std::string(batch.string(annotation.description)) + ":";
+        for (const auto& attr :
+             AttributesToStrings(batch, annotation.attributes)) {
+          s += " " + attr;
+        }
+        span.annotations.push_back(s);
+      }
+      const auto message_events = batch.message_event_ranges()[i];
+      for (uint32_t j = message_events.begin; j < message_events.end; ++j) {
+        span.message_event_ids.push_back(batch.message_events()[j].event.id());
+      }
+      const auto links = batch.link_ranges()[i];
+      for (uint32_t j = links.begin; j < links.end; ++j) {
+        span.link_span_ids.push_back(batch.links()[j].span_id);
+      }
+      span.num_attributes_dropped = batch.num_attributes_dropped()[i];
+      spans_->push_back(span);
+    }
+  }
+
+ private:
+  static absl::Mutex mu_;
+  static std::vector<BatchSpan>* spans_ ABSL_GUARDED_BY(mu_);
+  static std::vector<std::string>* strings_ ABSL_GUARDED_BY(mu_);
+  static std::vector<std::pair<std::string, const char*>>* string_data_
+      ABSL_GUARDED_BY(mu_);
+};
+
+absl::Mutex BatchRecorder::mu_;
+std::vector<BatchSpan>* BatchRecorder::spans_ = new std::vector<BatchSpan>;
+std::vector<std::string>* BatchRecorder::strings_ =
+    new std::vector<std::string>;
+std::vector<std::pair<std::string, const char*>>* BatchRecorder::string_data_ =
+    new std::vector<std::pair<std::string, const char*>>;
+
+// Records exported SpanData, to compare with the batches.
+class SpanDataRecorder : public exporter::SpanExporter::Handler {
+ public:
+  static std::vector<exporter::SpanData> TakeSpans() {
+    absl::MutexLock l(&mu_);
+    std::vector<exporter::SpanData> spans;
+    spans.swap(*spans_);
+    return spans;
+  }
+
+  void Export(const std::vector<exporter::SpanData>& spans) override {
+    absl::MutexLock l(&mu_);
+    spans_->insert(spans_->end(), spans.begin(), spans.end());
+  }
+
+ private:
+  static absl::Mutex mu_;
+  static std::vector<exporter::SpanData>* spans_ ABSL_GUARDED_BY(mu_);
+};
+
+absl::Mutex SpanDataRecorder::mu_;
+std::vector<exporter::SpanData>* SpanDataRecorder::spans_ =
+    new std::vector<exporter::SpanData>;
+
+class SpanBatchTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    exporter::SpanExporter::RegisterBatchHandler(
+        absl::make_unique<BatchRecorder>(), "batch");
+    exporter::SpanExporter::RegisterHandler(
+        absl::make_unique<SpanDataRecorder>(), "span_data");
+  }
+
+  void SetUp() override {
+    BatchRecorder::TakeSpans();
+    BatchRecorder::ClearStrings();
+    SpanDataRecorder::TakeSpans();
+  }
+
+  static AlwaysSampler sampler_;
+};
+
+AlwaysSampler SpanBatchTest::sampler_;
+
+TEST_F(SpanBatchTest, ColumnsMatchSpanData) {
+  auto parent = Span::StartSpan("Parent", nullptr, {&sampler_});
+  auto span = Span::StartSpan("Child", &parent);
+  span.AddAttributes({{"string", "value"}, {"int", 123}, {"bool", true}});
+  span.AddAnnotation("Annotation", {{"key", "value"}});
+  span.AddSentMessageEvent(7, 100, 200);
+  span.AddParentLink(parent.context());
+  span.SetStatus(StatusCode::UNAVAILABLE, "unavailable");
+  span.End();
+  parent.End();
+
+  const auto spans = BatchRecorder::TakeSpans();
+  const auto span_data = SpanDataRecorder::TakeSpans();
+  ASSERT_EQ(2, spans.size());
+  ASSERT_EQ(2, span_data.size());
+  for (size_t i = 0; i < spans.size(); ++i) {
+    EXPECT_EQ(span_data[i].name(), spans[i].name);
+    EXPECT_EQ(span_data[i].context().span_id(), spans[i].span_id);
+    EXPECT_EQ(span_data[i].parent_span_id(), spans[i].parent_span_id);
+    EXPECT_EQ(absl::ToUnixNanos(span_data[i].start_time()),
+              spans[i].start_time);
+    EXPECT_EQ(absl::ToUnixNanos(span_data[i].end_time()), spans[i].end_time);
+    EXPECT_EQ(span_data[i].status().CanonicalCode(), spans[i].status_code);
+    EXPECT_EQ(span_data[i].status().error_message(), spans[i].status_message);
+  }
+
+  const BatchSpan& child = spans[0];
+  EXPECT_EQ("Child", child.name);
+  EXPECT_EQ((std::vector<std::string>{"bool=true", "int=123", "string=value"}),
+            child.attributes);
+  EXPECT_EQ((std::vector<std::string>{"Annotation: key=value"}),
+            child.annotations);
+  EXPECT_EQ((std::vector<uint32_t>{7}), child.message_event_ids);
+  EXPECT_EQ((std::vector<SpanId>{parent.context().span_id()}),
+            child.link_span_ids);
+  EXPECT_EQ(0, child.num_attributes_dropped);
+  EXPECT_LE(child.start_time, child.end_time);
+
+  EXPECT_EQ("Parent", spans[1].name);
+  EXPECT_FALSE(spans[1].parent_span_id.IsValid());
+  EXPECT_TRUE(spans[1].attributes.empty());
+}
+
+TEST_F(SpanBatchTest, StringsAreDeduplicated) {
+  for (int i = 0; i < 10; ++i) {
+    auto span = Span::StartSpan("Repeated", nullptr, {&sampler_});
+    span.AddAttributes({{"key", "Repeated"}, {"other", "value"}});
+    span.End();
+  }
+  EXPECT_EQ(10, BatchRecorder::TakeSpans().size());
+  EXPECT_EQ(1, BatchRecorder::CountString("Repeated"));
+  EXPECT_EQ(1, BatchRecorder::CountString("key"));
+  EXPECT_EQ(1, BatchRecorder::CountString("value"));
+}
+
+TEST_F(SpanBatchTest, StaticStringsAreNotCopied) {
+  static const StaticString kKey = StaticString::Intern("interned_key");
+  static const StaticString kValue = StaticString::Literal("static_value");
+  auto span = Span::StartSpan("Static", nullptr, {&sampler_});
+  span.AddAttributes({{kKey, kValue}});
+  span.End();
+  EXPECT_EQ(1, BatchRecorder::TakeSpans().size());
+  EXPECT_EQ(kKey.view().data(), BatchRecorder::StringData("interned_key"));
+  EXPECT_EQ(kValue.view().data(), BatchRecorder::StringData("static_value"));
+}
+
+TEST_F(SpanBatchTest, HandlerStatsCountBatchHandlers) {
+  Span::StartSpan("Counted", nullptr, {&sampler_}).End();
+  BatchRecorder::TakeSpans();
+  bool found = false;
+  for (const auto& stats : exporter::SpanExporter::GetHandlerStats()) {
+    if (stats.name == "batch") {
+      found = true;
+      EXPECT_LT(0, stats.exported_spans);
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+}  // namespace
+}  // namespace trace
+}  // namespace opencensus
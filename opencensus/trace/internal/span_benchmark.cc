@@ -12,9 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
 #include "benchmark/benchmark.h"
+#include "opencensus/trace/exporter/span_data.h"
+#include "opencensus/trace/exporter/span_exporter.h"
 #include "opencensus/trace/span.h"
 #include "opencensus/trace/span_context.h"
+#include "opencensus/trace/trace_config.h"
+#include "opencensus/trace/trace_params.h"
 
 namespace {
 
@@ -26,7 +34,7 @@ void BM_StartEndSpan(benchmark::State& state) {
     span.End();
   }
 }
-BENCHMARK(BM_StartEndSpan);
+BENCHMARK(BM_StartEndSpan)->ThreadRange(1, 16);
 
 void BM_StartEndSpanAndAddAttribute(benchmark::State& state) {
   static ::opencensus::trace::AlwaysSampler sampler;
@@ -89,5 +97,70 @@ void BM_StartEndSpanAndSetStatus(benchmark::State& state) {
 }
 BENCHMARK(BM_StartEndSpanAndSetStatus);
 
+void BM_StartEndUnsampledSpan(benchmark::State& state) {
+  for (auto _ : state) {
+    // Sampled with the default probability of 1e-4.
+    auto span = ::opencensus::trace::Span::StartSpan("SpanName");
+    span.End();
+  }
+}
+BENCHMARK(BM_StartEndUnsampledSpan)->ThreadRange(1, 16);
+
+void BM_StartEndUnsampledChildSpan(benchmark::State& state) {
+  static ::opencensus::trace::NeverSampler sampler;
+  auto parent = ::opencensus::trace::Span::StartSpan(
+      "Parent", /*parent=*/nullptr, {&sampler});
+  for (auto _ : state) {
+    auto span = ::opencensus::trace::Span::StartSpan("SpanName", &parent);
+    span.End();
+  }
+  parent.End();
+}
+BENCHMARK(BM_StartEndUnsampledChildSpan)->ThreadRange(1, 16);
+
+void BM_StartEndSpanRecordingNothing(benchmark::State& state) {
+  const ::opencensus::trace::TraceParams default_params{
+      32, 32, 128, 32, ::opencensus::trace::ProbabilitySampler(1e-4)};
+  const ::opencensus::trace::TraceParams never_params{
+      32, 32, 128, 32, ::opencensus::trace::ProbabilitySampler(0.0)};
+  if (state.thread_index() == 0) {
+    ::opencensus::trace::TraceConfig::SetCurrentTraceParams(never_params);
+  }
+  for (auto _ : state) {
+    auto span = ::opencensus::trace::Span::StartSpan("SpanName");
+    span.End();
+  }
+  if (state.thread_index() == 0) {
+    ::opencensus::trace::TraceConfig::SetCurrentTraceParams(default_params);
+  }
+}
+BENCHMARK(BM_StartEndSpanRecordingNothing)->ThreadRange(1, 16);
+
+class NullExporter
+    : public ::opencensus::trace::exporter::SpanExporter::Handler {
+ public:
+  void Export(
+      const std::vector<::opencensus::trace::exporter::SpanData>&) override {}
+};
+
+// Registering a handler cannot be undone. Keep this benchmark last.
+void BM_StartEndSpanExported(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    static bool registered = false;
+    if (!registered) {
+      ::opencensus::trace::exporter::SpanExporter::RegisterHandler(
+          absl::make_unique<NullExporter>());
+      registered = true;
+    }
+  }
+  static ::opencensus::trace::AlwaysSampler sampler;
+  for (auto _ : state) {
+    auto span = ::opencensus::trace::Span::StartSpan(
+        "SpanName", /*parent=*/nullptr, {&sampler});
+    span.End();
+  }
+}
+BENCHMARK(BM_StartEndSpanExported)->ThreadRange(1, 16);
+
 }  // namespace
 BENCHMARK_MAIN();
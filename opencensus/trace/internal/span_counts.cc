@@ -0,0 +1,318 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/internal/span_counts.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "absl/base/optimization.h"
+#include "absl/hash/hash.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "opencensus/common/internal/clock.h"
+#include "opencensus/trace/internal/local_span_store_impl.h"
+#include "opencensus/trace/span_impl_ptr.h"
+#include "opencensus/trace/status_code.h"
+
+namespace opencensus {
+namespace trace {
+
+namespace {
+
+constexpr size_t kNumStatusCodes =
+    exporter::LocalSpanStoreImpl::kNumStatusCodes;
+
+// Threads are spread over this many copies of each counter.
+constexpr size_t kNumShards = 8;
+
+// The number of SpanCounters cached per thread.
+constexpr size_t kCacheSize = 64;
+
+static_assert(SpanCounts::kNumLatencyBuckets ==
+                  exporter::LocalSpanStoreImpl::kNumLatencyBuckets,
+              "SpanCounts uses the LocalSpanStore's latency buckets");
+
+// Returns the latency bucket of a duration in Clock ticks, which are
+// nanoseconds.
+size_t LatencyBucket(int64_t latency_ticks) {
+  size_t bucket = 0;
+  for (int64_t bound = 10000;
+       bucket + 1 < SpanCounts::kNumLatencyBuckets && latency_ticks >= bound;
+       bound *= 10) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+// Recycles the storage of CountedSpans. Each thread keeps its own free list.
+class CountedSpanPool final {
+ public:
+  static void* Allocate();
+  static void Release(void* storage);
+
+ private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  struct LocalPool {
+    ~LocalPool();
+    FreeSlot* head = nullptr;
+    size_t size = 0;
+  };
+
+  // A thread keeps at most this many free slots.
+  static constexpr size_t kMaxLocalSlots = 256;
+
+  // Returns this thread's pool, or nullptr if it has already been destroyed
+  // during thread exit.
+  static LocalPool* Local();
+};
+
+constexpr size_t CountedSpanPool::kMaxLocalSlots;
+
+// Trivially destructible, so it is still valid while thread_local objects
+// with destructors are being destroyed.
+thread_local bool local_counted_span_pool_destroyed = false;
+
+CountedSpanPool::LocalPool::~LocalPool() {
+  local_counted_span_pool_destroyed = true;
+  while (head != nullptr) {
+    FreeSlot* next = head->next;
+    ::operator delete(head);
+    head = next;
+  }
+}
+
+CountedSpanPool::LocalPool* CountedSpanPool::Local() {
+  if (local_counted_span_pool_destroyed) return nullptr;
+  static thread_local LocalPool pool;
+  return &pool;
+}
+
+void* CountedSpanPool::Allocate() {
+  LocalPool* pool = Local();
+  if (pool != nullptr && pool->head != nullptr) {
+    FreeSlot* slot = pool->head;
+    pool->head = slot->next;
+    --pool->size;
+    return slot;
+  }
+  return ::operator new(sizeof(CountedSpan));
+}
+
+void CountedSpanPool::Release(void* storage) {
+  LocalPool* pool = Local();
+  if (pool == nullptr || pool->size >= kMaxLocalSlots) {
+    ::operator delete(storage);
+    return;
+  }
+  pool->head = new (storage) FreeSlot{pool->head};
+  ++pool->size;
+}
+
+// Returns this thread's shard.
+size_t ShardIndex() {
+  static std::atomic<size_t> next_shard(0);
+  static thread_local const size_t shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % kNumShards;
+  return shard;
+}
+
+}  // namespace
+
+class SpanCounter final {
+ public:
+  explicit SpanCounter(absl::string_view name) : name_(name) {
+    for (auto& cell : cells_) {
+      cell.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~SpanCounter() {
+    for (auto& cell : cells_) {
+      delete cell.load(std::memory_order_relaxed);
+    }
+  }
+
+  const std::string& name() const { return name_; }
+
+  void Add(StatusCode status_code, size_t bucket) {
+    if (status_code >= kNumStatusCodes) {
+      status_code = StatusCode::UNKNOWN;
+    }
+    Cell* cell = cells_[status_code].load(std::memory_order_acquire);
+    if (cell == nullptr) {
+      cell = NewCell(status_code);
+    }
+    cell->shards[ShardIndex()].counts[bucket].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  // Calls f with the counts added since the previous call. Calls must be
+  // serialized.
+  void Flush(const SpanCounts::FlushFunction& f) {
+    for (size_t code = 0; code < kNumStatusCodes; ++code) {
+      Cell* cell = cells_[code].load(std::memory_order_acquire);
+      if (cell == nullptr) continue;
+      uint64_t deltas[SpanCounts::kNumLatencyBuckets];
+      bool any = false;
+      for (size_t bucket = 0; bucket < SpanCounts::kNumLatencyBuckets;
+           ++bucket) {
+        uint64_t total = 0;
+        for (const auto& shard : cell->shards) {
+          total += shard.counts[bucket].load(std::memory_order_relaxed);
+        }
+        deltas[bucket] = total - cell->flushed[bucket];
+        cell->flushed[bucket] = total;
+        any = any || deltas[bucket] != 0;
+      }
+      if (any) {
+        f(name_, static_cast<StatusCode>(code), deltas);
+      }
+    }
+  }
+
+ private:
+  // The counts of one status, allocated when it is first seen.
+  struct Cell {
+    struct Shard {
+      std::atomic<uint64_t> counts[SpanCounts::kNumLatencyBuckets];
+      // Keeps neighbouring shards' counts off this cache line.
+      char pad[ABSL_CACHELINE_SIZE];
+    };
+    Shard shards[kNumShards];
+    // The counts at the previous Flush().
+    uint64_t flushed[SpanCounts::kNumLatencyBuckets];
+  };
+
+  Cell* NewCell(StatusCode status_code) {
+    // Value-initialization zeroes the counts.
+    Cell* cell = new Cell();
+    Cell* existing = nullptr;
+    if (!cells_[status_code].compare_exchange_strong(
+            existing, cell, std::memory_order_acq_rel)) {
+      delete cell;  // Another thread got there first.
+      return existing;
+    }
+    return cell;
+  }
+
+  const std::string name_;
+  std::atomic<Cell*> cells_[kNumStatusCodes];
+};
+
+CountedSpan::CountedSpan(SpanCounter* counter, int64_t start_ticks)
+    : counter_(counter), start_ticks_(start_ticks) {}
+
+// static
+CountedSpanPtr CountedSpan::Create(absl::string_view name) {
+  SpanCounter* counter = SpanCounts::Get()->GetCounter(name);
+  return CountedSpanPtr::Adopt(new (CountedSpanPool::Allocate()) CountedSpan(
+      counter, common::Clock::NowTicks()));
+}
+
+void CountedSpan::SetName(absl::string_view name) {
+  counter_.store(SpanCounts::Get()->GetCounter(name),
+                 std::memory_order_relaxed);
+}
+
+void CountedSpan::End() {
+  if (ended_.exchange(true, std::memory_order_relaxed)) return;
+  SpanCounts::Add(counter_.load(std::memory_order_relaxed),
+                  status_code_.load(std::memory_order_relaxed),
+                  common::Clock::NowTicks() - start_ticks_);
+}
+
+void IntrusiveRef(CountedSpan* span) {
+  span->ref_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IntrusiveUnref(CountedSpan* span) {
+  if (span->ref_count_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  span->~CountedSpan();
+  CountedSpanPool::Release(span);
+}
+
+constexpr size_t SpanCounts::kNumLatencyBuckets;
+constexpr size_t SpanCounts::kMaxNames;
+const char SpanCounts::kOtherName[] = "(other)";
+
+SpanCounts* SpanCounts::Get() {
+  static SpanCounts* global_span_counts = new SpanCounts;
+  return global_span_counts;
+}
+
+SpanCounter* SpanCounts::GetCounter(absl::string_view name) {
+  struct CacheEntry {
+    size_t hash;
+    SpanCounter* counter;
+  };
+  static thread_local CacheEntry cache[kCacheSize] = {};
+  const size_t hash = absl::Hash<absl::string_view>()(name);
+  CacheEntry& entry = cache[hash % kCacheSize];
+  // Names that overflowed to kOtherName are matched by hash alone, so that
+  // they don't always take the lock.
+  if (entry.counter == nullptr || entry.hash != hash ||
+      (entry.counter->name() != name &&
+       entry.counter->name() != kOtherName)) {
+    entry.hash = hash;
+    entry.counter = GetCounterSlow(name);
+  }
+  return entry.counter;
+}
+
+SpanCounter* SpanCounts::GetCounterSlow(absl::string_view name) {
+  absl::MutexLock l(&mu_);
+  const auto it = counters_.find(name);
+  if (it != counters_.end()) {
+    return it->second.get();
+  }
+  if (counters_.size() >= kMaxNames || name == kOtherName) {
+    if (other_ == nullptr) {
+      other_ = absl::make_unique<SpanCounter>(kOtherName);
+    }
+    return other_.get();
+  }
+  auto counter = absl::make_unique<SpanCounter>(name);
+  SpanCounter* const result = counter.get();
+  counters_.emplace(result->name(), std::move(counter));
+  return result;
+}
+
+// static
+void SpanCounts::Add(SpanCounter* counter, StatusCode status_code,
+                     int64_t latency_ticks) {
+  counter->Add(status_code, LatencyBucket(latency_ticks));
+}
+
+void SpanCounts::Flush(const FlushFunction& f) {
+  absl::MutexLock l(&mu_);
+  for (const auto& counter : counters_) {
+    counter.second->Flush(f);
+  }
+  if (other_ != nullptr) {
+    other_->Flush(f);
+  }
+}
+
+}  // namespace trace
+}  // namespace opencensus
@@ -0,0 +1,142 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_TRACE_INTERNAL_SPAN_COUNTS_H_
+#define OPENCENSUS_TRACE_INTERNAL_SPAN_COUNTS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "opencensus/trace/span_impl_ptr.h"
+#include "opencensus/trace/status_code.h"
+
+namespace opencensus {
+namespace trace {
+
+// The counts of ended spans of one name. Defined in span_counts.cc.
+class SpanCounter;
+
+// SpanCounts counts ended spans, sampled or not, by name and status, in the
+// latency buckets of the LocalSpanStore. Counting a span increments a single
+// counter, in one of several shards so that threads rarely write to the same
+// cache line. A Span that isn't recording is tracked by a CountedSpan, so it
+// needs no SpanImpl to be counted.
+//
+// Counting is off until Enable(). This is not a public API: it lets libraries
+// that depend on trace, like ../span_metrics.h, read the counts with Flush().
+//
+// This class is thread-safe and a singleton.
+class SpanCounts final {
+ public:
+  // The LocalSpanStore's latency buckets: [0, 10us), [10us, 100us), ...,
+  // [10s, 100s), [100s, inf).
+  static constexpr size_t kNumLatencyBuckets = 9;
+
+  // Spans with names beyond the first kMaxNames are counted under kOtherName.
+  static constexpr size_t kMaxNames = 1024;
+  static const char kOtherName[];
+
+  using FlushFunction = std::function<void(
+      absl::string_view name, StatusCode status_code,
+      absl::Span<const uint64_t> latency_counts)>;
+
+  // Returns the global instance of SpanCounts.
+  static SpanCounts* Get();
+
+  // Starts or stops counting spans that start from now on. Spans that already
+  // have a SpanCounter are still counted when they end.
+  void Enable() { enabled_.store(true, std::memory_order_relaxed); }
+  void Disable() { enabled_.store(false, std::memory_order_relaxed); }
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Returns the SpanCounter for spans named 'name'. SpanCounters are never
+  // freed. Each thread caches the SpanCounters of recent names.
+  SpanCounter* GetCounter(absl::string_view name) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Counts an ended span.
+  static void Add(SpanCounter* counter, StatusCode status_code,
+                  int64_t latency_ticks);
+
+  // Calls f with the number of spans in each latency bucket that ended since
+  // the previous call, for each name and status with new spans.
+  void Flush(const FlushFunction& f) ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  SpanCounts() = default;
+
+  SpanCounter* GetCounterSlow(absl::string_view name) ABSL_LOCKS_EXCLUDED(mu_);
+
+  std::atomic<bool> enabled_{false};
+  absl::Mutex mu_;
+  // Keyed by the SpanCounter's name.
+  std::unordered_map<absl::string_view, std::unique_ptr<SpanCounter>,
+                     absl::Hash<absl::string_view>>
+      counters_ ABSL_GUARDED_BY(mu_);
+  // Created when kMaxNames is reached.
+  std::unique_ptr<SpanCounter> other_ ABSL_GUARDED_BY(mu_);
+};
+
+// CountedSpan tracks the SpanCounter, status and start time of a Span that
+// isn't recording while SpanCounts is enabled. Every copy of the Span shares
+// it, like a SpanImpl, so that a status set through one copy is counted when
+// another copy ends the Span, and the Span is counted only once. CountedSpans
+// are recycled through a pool per thread, since Spans that aren't recording
+// usually end on the thread that started them.
+//
+// This class is thread-safe.
+class CountedSpan final {
+ public:
+  CountedSpan(const CountedSpan&) = delete;
+  CountedSpan& operator=(const CountedSpan&) = delete;
+
+  // Starts tracking a span named 'name'.
+  static CountedSpanPtr Create(absl::string_view name);
+
+  void SetStatus(StatusCode status_code) {
+    status_code_.store(status_code, std::memory_order_relaxed);
+  }
+
+  void SetName(absl::string_view name);
+
+  // Counts the span the first time it is called.
+  void End();
+
+ private:
+  friend void IntrusiveRef(CountedSpan* span);
+  friend void IntrusiveUnref(CountedSpan* span);
+
+  CountedSpan(SpanCounter* counter, int64_t start_ticks);
+  ~CountedSpan() = default;
+
+  std::atomic<int32_t> ref_count_{1};
+  std::atomic<bool> ended_{false};
+  std::atomic<StatusCode> status_code_{StatusCode::OK};
+  std::atomic<SpanCounter*> counter_;
+  // In common::Clock ticks.
+  const int64_t start_ticks_;
+};
+
+}  // namespace trace
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_TRACE_INTERNAL_SPAN_COUNTS_H_
@@ -14,9 +14,12 @@
 
 #include "opencensus/trace/exporter/span_exporter.h"
 
+#include <cstddef>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "opencensus/trace/internal/span_exporter_impl.h"
 
@@ -34,9 +37,35 @@ void SpanExporter::SetInterval(absl::Duration interval) {
   SpanExporterImpl::Get()->SetInterval(interval);
 }
 
+constexpr size_t SpanExporter::kMaxBufferedSpans;
+constexpr size_t SpanExporter::kHandlerQueueCapacity;
+constexpr size_t SpanExporter::kNumExportLatencyBuckets;
+
+// static
+void SpanExporter::SetBufferOptions(const BufferOptions& options) {
+  SpanExporterImpl::Get()->SetBufferOptions(options);
+}
+
+// static
+SpanExporter::BufferStats SpanExporter::GetBufferStats() {
+  return SpanExporterImpl::Get()->GetBufferStats();
+}
+
+// static
+void SpanExporter::RegisterHandler(std::unique_ptr<Handler> handler,
+                                   absl::string_view name) {
+  SpanExporterImpl::Get()->RegisterHandler(std::move(handler), name);
+}
+
+// static
+void SpanExporter::RegisterBatchHandler(std::unique_ptr<BatchHandler> handler,
+                                        absl::string_view name) {
+  SpanExporterImpl::Get()->RegisterBatchHandler(std::move(handler), name);
+}
+
 // static
-void SpanExporter::RegisterHandler(std::unique_ptr<Handler> handler) {
-  SpanExporterImpl::Get()->RegisterHandler(std::move(handler));
+std::vector<SpanExporter::HandlerStats> SpanExporter::GetHandlerStats() {
+  return SpanExporterImpl::Get()->GetHandlerStats();
 }
 
 // static
@@ -15,21 +15,61 @@
 #include "opencensus/trace/internal/span_exporter_impl.h"
 
 #include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "opencensus/common/internal/clock.h"
+#include "opencensus/trace/exporter/span_batch.h"
 #include "opencensus/trace/exporter/span_data.h"
 #include "opencensus/trace/exporter/span_exporter.h"
+#include "opencensus/trace/internal/local_span_store_impl.h"
+#include "opencensus/trace/trace_id.h"
 
 namespace opencensus {
 namespace trace {
 namespace exporter {
 
+namespace {
+
+// Returns the index in HandlerStats::export_latency_counts for a latency: the
+// buckets are decades starting at 10us.
+size_t ExportLatencyBucket(absl::Duration latency) {
+  size_t bucket = 0;
+  for (absl::Duration bound = absl::Microseconds(10);
+       latency >= bound &&
+       bucket < SpanExporter::kNumExportLatencyBuckets - 1;
+       bound *= 10) {
+    ++bucket;
+  }
+  return bucket;
+}
+
+}  // namespace
+
 SpanExporterImpl* SpanExporterImpl::Get() {
   static SpanExporterImpl* global_span_exporter_impl = new SpanExporterImpl;
   return global_span_exporter_impl;
 }
 
+SpanExporterImpl::SpanExporterImpl()
+    : spans_(SpanExporter::kMaxBufferedSpans) {
+  // Spans are always collected, since they feed the LocalSpanStore even when
+  // no handler is registered.
+  t_ = std::thread(&SpanExporterImpl::RunWorkerLoop, this);
+}
+
 void SpanExporterImpl::SetBatchSize(int size) {
   absl::MutexLock l(&handler_mu_);
   batch_size_ = std::max(1, size);
@@ -40,37 +80,166 @@ void SpanExporterImpl::SetInterval(absl::Duration interval) {
   interval_ = std::max(absl::Seconds(1), interval);
 }
 
+void SpanExporterImpl::SetBufferOptions(
+    const SpanExporter::BufferOptions& options) {
+  max_spans_.store(
+      std::min(std::max<size_t>(options.max_spans, 1),
+               SpanExporter::kMaxBufferedSpans),
+      std::memory_order_relaxed);
+  overflow_policy_.store(options.overflow_policy, std::memory_order_relaxed);
+  trace_shift_.store(0, std::memory_order_relaxed);
+}
+
+SpanExporter::BufferStats SpanExporterImpl::GetBufferStats() const {
+  SpanExporter::BufferStats stats;
+  stats.buffered_spans = spans_.SizeApprox();
+  stats.dropped_newest = dropped_newest_.load(std::memory_order_relaxed);
+  stats.dropped_oldest = dropped_oldest_.load(std::memory_order_relaxed);
+  stats.dropped_by_trace = dropped_by_trace_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void SpanExporterImpl::SetBufferStatsListener(
+    std::function<void(const SpanExporter::BufferStats&)> listener) {
+  absl::MutexLock l(&handler_mu_);
+  buffer_stats_listener_ = std::move(listener);
+}
+
+void SpanExporterImpl::SetExportListener(std::function<void()> listener) {
+  absl::MutexLock l(&handler_mu_);
+  export_listener_ = std::move(listener);
+}
+
 void SpanExporterImpl::RegisterHandler(
-    std::unique_ptr<SpanExporter::Handler> handler) {
+    std::unique_ptr<SpanExporter::Handler> handler, absl::string_view name) {
   absl::MutexLock l(&handler_mu_);
-  handlers_.emplace_back(std::move(handler));
-  if (!thread_started_) {
-    StartExportThread();
+  handlers_.emplace_back(
+      absl::make_unique<HandlerWorker>(std::move(handler), name));
+}
+
+void SpanExporterImpl::RegisterBatchHandler(
+    std::unique_ptr<SpanExporter::BatchHandler> handler,
+    absl::string_view name) {
+  absl::MutexLock l(&handler_mu_);
+  handlers_.emplace_back(
+      absl::make_unique<HandlerWorker>(std::move(handler), name));
+  ++num_batch_handlers_;
+}
+
+std::vector<SpanExporter::HandlerStats> SpanExporterImpl::GetHandlerStats()
+    const {
+  std::vector<SpanExporter::HandlerStats> stats;
+  absl::MutexLock l(&handler_mu_);
+  stats.reserve(handlers_.size());
+  for (const auto& handler : handlers_) {
+    stats.push_back(handler->GetStats());
   }
+  return stats;
 }
 
-void SpanExporterImpl::AddSpan(
-    const std::shared_ptr<opencensus::trace::SpanImpl>& span_impl) {
-  absl::MutexLock l(&span_mu_);
-  if (!collect_spans_) return;
-  spans_.emplace_back(span_impl);
+bool SpanExporterImpl::KeepTrace(const TraceId& trace_id, size_t size,
+                                 size_t max_spans) {
+  int shift = trace_shift_.load(std::memory_order_relaxed);
+  const size_t half = max_spans / 2;
+  if (size >= half && half > 0) {
+    // Keep at most the fraction room / half of traces, rounded down to a power
+    // of two so that the kept traces only change when it halves. Each kept
+    // set is a subset of the previous one.
+    const size_t room = max_spans - size;
+    int wanted = 0;
+    while ((half >> wanted) > room) ++wanted;
+    while (shift < wanted &&
+           !trace_shift_.compare_exchange_weak(shift, wanted,
+                                               std::memory_order_relaxed)) {
+    }
+    shift = std::max(shift, wanted);
+  }
+  if (shift == 0) return true;
+  // TraceIds are random, so their leading bytes are uniform.
+  uint64_t hash;
+  memcpy(&hash, trace_id.Value(), sizeof(hash));
+  return hash >> (64 - shift) == 0;
 }
 
-void SpanExporterImpl::StartExportThread() {
-  t_ = std::thread(&SpanExporterImpl::RunWorkerLoop, this);
-  thread_started_ = true;
-  absl::MutexLock l(&span_mu_);
-  collect_spans_ = true;
+void SpanExporterImpl::UpdateTraceSampling(size_t drained) {
+  const uint64_t dropped = dropped_by_trace_.load(std::memory_order_relaxed);
+  const uint64_t arrived = drained + (dropped - exported_dropped_by_trace_);
+  exported_dropped_by_trace_ = dropped;
+  const absl::Time now = absl::Now();
+  if (arrived >= max_spans_.load(std::memory_order_relaxed) / 2) {
+    last_overflow_ = now;
+  } else if (now - last_overflow_ >= interval_) {
+    trace_shift_.store(0, std::memory_order_relaxed);
+  }
+}
+
+void SpanExporterImpl::AddSpan(const SpanImplPtr& span_impl) {
+  const size_t max_spans = max_spans_.load(std::memory_order_relaxed);
+  const SpanExporter::OverflowPolicy policy =
+      overflow_policy_.load(std::memory_order_relaxed);
+  const size_t size = spans_.SizeApprox();
+  if (size >= max_spans) {
+    if (policy != SpanExporter::OverflowPolicy::kDropOldest) {
+      dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    SpanImplPtr oldest;
+    if (spans_.TryPop(&oldest)) {
+      dropped_oldest_.fetch_add(1, std::memory_order_relaxed);
+    }
+  } else if (policy == SpanExporter::OverflowPolicy::kSampleByTrace &&
+             !KeepTrace(span_impl->context().trace_id(), size, max_spans)) {
+    dropped_by_trace_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  SpanImplPtr span = span_impl;
+  if (!spans_.TryPush(std::move(span))) {
+    dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  if (spans_.SizeApprox() >=
+          static_cast<size_t>(
+              cached_batch_size_.load(std::memory_order_relaxed)) &&
+      !worker_woken_.exchange(true, std::memory_order_relaxed)) {
+    // Releasing span_mu_ makes the worker re-evaluate IsBatchFull().
+    absl::MutexLock l(&span_mu_);
+  }
 }
 
 bool SpanExporterImpl::IsBatchFull() const {
   span_mu_.AssertHeld();
-  return spans_.size() >= static_cast<size_t>(cached_batch_size_);
+  return spans_.SizeApprox() >=
+         static_cast<size_t>(
+             cached_batch_size_.load(std::memory_order_relaxed));
+}
+
+void SpanExporterImpl::DrainSpans(std::vector<SpanImplPtr>* spans) {
+  spans->reserve(spans_.SizeApprox());
+  SpanImplPtr span;
+  for (size_t i = 0; i < spans_.capacity() && spans_.TryPop(&span); ++i) {
+    spans->push_back(std::move(span));
+  }
+}
+
+// static
+std::vector<SpanData> SpanExporterImpl::TakeStoredSpanData(
+    const std::vector<SpanImplPtr>& spans) {
+  std::vector<LocalSpanStoreImpl::SpanKey> keys;
+  keys.reserve(spans.size());
+  for (const auto& span : spans) {
+    const SpanImpl::EndedSpan ended = span->GetEndedSpan();
+    keys.push_back({ended.name, absl::Nanoseconds(ended.latency_ticks),
+                    ended.status_code});
+  }
+  const std::vector<bool> stored = LocalSpanStoreImpl::Get()->SelectSpans(keys);
+  std::vector<SpanData> span_data;
+  for (size_t i = 0; i < spans.size(); ++i) {
+    if (stored[i]) span_data.push_back(spans[i]->TakeSpanData());
+  }
+  return span_data;
 }
 
 void SpanExporterImpl::RunWorkerLoop() {
-  std::vector<opencensus::trace::exporter::SpanData> span_data;
-  std::vector<std::shared_ptr<opencensus::trace::SpanImpl>> batch;
   // Thread loops forever.
   // TODO: Add in shutdown mechanism.
   while (true) {
@@ -79,50 +248,152 @@ void SpanExporterImpl::RunWorkerLoop() {
     {
       // Start of loop, update batch size and interval.
       absl::MutexLock l(&handler_mu_);
-      size = batch_size_;
+      size = static_cast<int>(std::min<size_t>(
+          batch_size_, max_spans_.load(std::memory_order_relaxed)));
       next_forced_export_time = absl::Now() + interval_;
     }
     {
       absl::MutexLock l(&span_mu_);
-      cached_batch_size_ = size;
+      cached_batch_size_.store(size, std::memory_order_relaxed);
+      // Allow the next full batch to wake us.
+      worker_woken_.store(false, std::memory_order_relaxed);
       // Wait until batch is full or interval time has been exceeded.
       span_mu_.AwaitWithDeadline(
           absl::Condition(this, &SpanExporterImpl::IsBatchFull),
           next_forced_export_time);
-      if (spans_.empty()) {
-        continue;
-      }
-      std::swap(batch, spans_);
     }
-    for (const auto& span : batch) {
-      span_data.emplace_back(span->ToSpanData());
+    {
+      absl::MutexLock l(&handler_mu_);
+      Export();
     }
-    batch.clear();
-    Export(span_data);
-    span_data.clear();
   }
 }
 
-void SpanExporterImpl::Export(const std::vector<SpanData>& span_data) {
-  // Call each registered handler.
-  absl::MutexLock lock(&handler_mu_);
+void SpanExporterImpl::Export() {
+  std::vector<SpanImplPtr> spans;
+  DrainSpans(&spans);
+  UpdateTraceSampling(spans.size());
+  if (buffer_stats_listener_) {
+    buffer_stats_listener_(GetBufferStats());
+  }
+  if (export_listener_) {
+    export_listener_();
+  }
+  if (spans.empty()) {
+    return;
+  }
+  Batch batch;
+  if (num_batch_handlers_ > 0) {
+    auto span_batch = absl::make_unique<SpanBatch>();
+    span_batch->Reserve(spans.size());
+    // The batch reads the spans before TakeSpanData() moves their contents
+    // out.
+    for (const auto& span : spans) {
+      span->AppendTo(span_batch.get());
+    }
+    span_batch->FinishBuilding();
+    batch.span_batch = std::move(span_batch);
+  }
+  if (handlers_.size() > num_batch_handlers_) {
+    // Handlers need every span as SpanData, which the LocalSpanStore shares.
+    std::vector<SpanData> span_data;
+    span_data.reserve(spans.size());
+    for (const auto& span : spans) {
+      span_data.push_back(span->TakeSpanData());
+    }
+    LocalSpanStoreImpl::Get()->AddSpans(span_data);
+    batch.span_data =
+        std::make_shared<const std::vector<SpanData>>(std::move(span_data));
+  } else {
+    // Otherwise only the spans the LocalSpanStore keeps are converted.
+    LocalSpanStoreImpl::Get()->AddSpans(TakeStoredSpanData(spans));
+  }
   for (const auto& handler : handlers_) {
-    handler->Export(span_data);
+    handler->Enqueue(batch);
   }
 }
 
 void SpanExporterImpl::ExportForTesting() {
-  std::vector<opencensus::trace::exporter::SpanData> span_data_;
-  std::vector<std::shared_ptr<opencensus::trace::SpanImpl>> batch_;
-  {
-    absl::MutexLock l(&span_mu_);
-    std::swap(batch_, spans_);
+  absl::MutexLock l(&handler_mu_);
+  Export();
+  for (const auto& handler : handlers_) {
+    handler->Flush();
   }
-  span_data_.reserve(batch_.size());
-  for (const auto& span : batch_) {
-    span_data_.emplace_back(span->ToSpanData());
+}
+
+SpanExporterImpl::HandlerWorker::HandlerWorker(
+    std::unique_ptr<SpanExporter::Handler> handler, absl::string_view name)
+    : HandlerWorker(std::move(handler), nullptr, name) {}
+
+SpanExporterImpl::HandlerWorker::HandlerWorker(
+    std::unique_ptr<SpanExporter::BatchHandler> handler,
+    absl::string_view name)
+    : HandlerWorker(nullptr, std::move(handler), name) {}
+
+SpanExporterImpl::HandlerWorker::HandlerWorker(
+    std::unique_ptr<SpanExporter::Handler> handler,
+    std::unique_ptr<SpanExporter::BatchHandler> batch_handler,
+    absl::string_view name)
+    : handler_(std::move(handler)), batch_handler_(std::move(batch_handler)) {
+  stats_.name = std::string(name);
+  t_ = std::thread(&HandlerWorker::RunWorkerLoop, this);
+}
+
+void SpanExporterImpl::HandlerWorker::Enqueue(const Batch& batch) {
+  const size_t size = batch.size();
+  // Only hold on to the form of the batch that this handler exports.
+  Batch queued;
+  if (is_batch_handler()) {
+    queued.span_batch = batch.span_batch;
+  } else {
+    queued.span_data = batch.span_data;
+  }
+  absl::MutexLock l(&mu_);
+  if (queued_spans_ + size > SpanExporter::kHandlerQueueCapacity) {
+    stats_.dropped_spans += size;
+    return;
+  }
+  batches_.push_back(std::move(queued));
+  queued_spans_ += size;
+}
+
+void SpanExporterImpl::HandlerWorker::Flush() {
+  absl::MutexLock l(&mu_);
+  mu_.Await(absl::Condition(this, &HandlerWorker::IsIdle));
+}
+
+SpanExporter::HandlerStats SpanExporterImpl::HandlerWorker::GetStats() const {
+  absl::MutexLock l(&mu_);
+  SpanExporter::HandlerStats stats = stats_;
+  stats.queued_batches = batches_.size();
+  return stats;
+}
+
+void SpanExporterImpl::HandlerWorker::RunWorkerLoop() {
+  // Thread loops forever, like the SpanExporterImpl worker.
+  while (true) {
+    Batch batch;
+    {
+      absl::MutexLock l(&mu_);
+      mu_.Await(absl::Condition(this, &HandlerWorker::HasBatches));
+      batch = std::move(batches_.front());
+      batches_.pop_front();
+      queued_spans_ -= batch.size();
+      exporting_ = true;
+    }
+    const int64_t start = common::Clock::NowTicks();
+    if (is_batch_handler()) {
+      batch_handler_->Export(*batch.span_batch);
+    } else {
+      handler_->Export(*batch.span_data);
+    }
+    const absl::Duration latency =
+        common::Clock::ToDuration(start, common::Clock::NowTicks());
+    absl::MutexLock l(&mu_);
+    exporting_ = false;
+    stats_.exported_spans += batch.size();
+    ++stats_.export_latency_counts[ExportLatencyBucket(latency)];
   }
-  Export(span_data_);
 }
 
 }  // namespace exporter
@@ -15,6 +15,10 @@
 #ifndef OPENCENSUS_TRACE_INTERNAL_SPAN_EXPORTER_IMPL_H_
 #define OPENCENSUS_TRACE_INTERNAL_SPAN_EXPORTER_IMPL_H_
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
@@ -22,11 +26,16 @@
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "opencensus/common/internal/bounded_queue.h"
+#include "opencensus/trace/exporter/span_batch.h"
 #include "opencensus/trace/exporter/span_data.h"
 #include "opencensus/trace/exporter/span_exporter.h"
 #include "opencensus/trace/internal/span_impl.h"
+#include "opencensus/trace/span_impl_ptr.h"
+#include "opencensus/trace/trace_id.h"
 
 namespace opencensus {
 namespace trace {
@@ -46,18 +55,39 @@ class SpanExporterImpl {
 
   void SetBatchSize(int size);
   void SetInterval(absl::Duration interval);
+  void SetBufferOptions(const SpanExporter::BufferOptions& options);
 
-  // A shared_ptr to the span is added to a list. The actual conversion to
-  // SpanData will take place at a later time via the background thread. This
-  // is intended to be called at the Span::End().
-  void AddSpan(const std::shared_ptr<opencensus::trace::SpanImpl>& span_impl);
+  // A reference to the span is added to a queue. The actual conversion to
+  // SpanData will take place at a later time via the background thread, which
+  // adds the SpanData to the LocalSpanStore and queues it for the registered
+  // handlers, along with a SpanBatch if there are BatchHandlers. This is
+  // intended to be called at the Span::End(). It does not block: when the
+  // queue is over budget, the overflow policy decides which span is dropped.
+  void AddSpan(const SpanImplPtr& span_impl);
 
-  // Registers a handler with the exporter. This is intended to be done at
-  // initialization.
-  void RegisterHandler(std::unique_ptr<SpanExporter::Handler> handler);
+  SpanExporter::BufferStats GetBufferStats() const;
+
+  // Sets a function that the worker calls with the buffer statistics after
+  // each export, e.g. to record them as metrics. nullptr removes it.
+  void SetBufferStatsListener(
+      std::function<void(const SpanExporter::BufferStats&)> listener);
+
+  // Sets a function that the worker calls after each export, so at least once
+  // per export interval, e.g. to flush aggregated metrics. nullptr removes it.
+  void SetExportListener(std::function<void()> listener);
+
+  // Registers a handler with the exporter and starts its thread. This is
+  // intended to be done at initialization.
+  void RegisterHandler(std::unique_ptr<SpanExporter::Handler> handler,
+                       absl::string_view name);
+  void RegisterBatchHandler(std::unique_ptr<SpanExporter::BatchHandler> handler,
+                            absl::string_view name);
+
+  std::vector<SpanExporter::HandlerStats> GetHandlerStats() const;
 
  private:
-  SpanExporterImpl() = default;
+  // Starts the worker thread.
+  SpanExporterImpl();
   SpanExporterImpl(const SpanExporterImpl&) = delete;
   SpanExporterImpl(SpanExporterImpl&&) = delete;
   SpanExporterImpl& operator=(const SpanExporterImpl&) = delete;
@@ -65,33 +95,135 @@ class SpanExporterImpl {
   friend class Span;
   friend class SpanExporter;  // For ExportForTesting() only.
 
-  void StartExportThread() ABSL_EXCLUSIVE_LOCKS_REQUIRED(handler_mu_);
+  // An exported batch of spans, as SpanData for Handlers and as a SpanBatch
+  // for BatchHandlers. Either is null if no handler takes it. Batches are
+  // shared between handlers.
+  struct Batch {
+    std::shared_ptr<const std::vector<SpanData>> span_data;
+    std::shared_ptr<const SpanBatch> span_batch;
+
+    size_t size() const {
+      return span_data != nullptr ? span_data->size() : span_batch->size();
+    }
+  };
+
+  // A registered Handler or BatchHandler, with the queue of batches that it
+  // has yet to export and the thread that exports them.
+  class HandlerWorker {
+   public:
+    HandlerWorker(std::unique_ptr<SpanExporter::Handler> handler,
+                  absl::string_view name);
+    HandlerWorker(std::unique_ptr<SpanExporter::BatchHandler> handler,
+                  absl::string_view name);
+
+    bool is_batch_handler() const { return batch_handler_ != nullptr; }
+
+    // Queues the form of the batch that the handler takes, or drops it if the
+    // queue would exceed kHandlerQueueCapacity spans.
+    void Enqueue(const Batch& batch) ABSL_LOCKS_EXCLUDED(mu_);
+
+    // Blocks until every queued batch has been exported.
+    void Flush() ABSL_LOCKS_EXCLUDED(mu_);
+
+    SpanExporter::HandlerStats GetStats() const ABSL_LOCKS_EXCLUDED(mu_);
+
+   private:
+    HandlerWorker(std::unique_ptr<SpanExporter::Handler> handler,
+                  std::unique_ptr<SpanExporter::BatchHandler> batch_handler,
+                  absl::string_view name);
+
+    void RunWorkerLoop();
+
+    bool HasBatches() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return !batches_.empty();
+    }
+    bool IsIdle() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return batches_.empty() && !exporting_;
+    }
+
+    // Exactly one of handler_ and batch_handler_ is set.
+    const std::unique_ptr<SpanExporter::Handler> handler_;
+    const std::unique_ptr<SpanExporter::BatchHandler> batch_handler_;
+    mutable absl::Mutex mu_;
+    std::deque<Batch> batches_ ABSL_GUARDED_BY(mu_);
+    // The number of spans in batches_.
+    size_t queued_spans_ ABSL_GUARDED_BY(mu_) = 0;
+    // True while a batch is being exported.
+    bool exporting_ ABSL_GUARDED_BY(mu_) = false;
+    SpanExporter::HandlerStats stats_ ABSL_GUARDED_BY(mu_);
+    std::thread t_;
+  };
+
   void RunWorkerLoop();
 
-  // Calls all registered handlers and exports the spans contained in span_data.
-  void Export(const std::vector<SpanData>& span_data);
+  // Pops queued spans, converts them to a SpanBatch if there are BatchHandlers
+  // and to SpanData if there are Handlers, adds them to the LocalSpanStore and
+  // queues them for all registered handlers. Without Handlers, only the spans
+  // that the LocalSpanStore keeps are converted to SpanData. Holding
+  // handler_mu_ throughout means that once ExportForTesting() has the lock, no
+  // span is half way through the pipeline.
+  void Export() ABSL_EXCLUSIVE_LOCKS_REQUIRED(handler_mu_);
 
   // Only for testing purposes: runs the export on the current thread and
-  // returns when complete.
+  // returns when every handler has exported the spans.
   void ExportForTesting();
 
+  // Pops up to a queue's worth of spans.
+  void DrainSpans(std::vector<SpanImplPtr>* spans)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(handler_mu_);
+
+  // Converts the spans that the LocalSpanStore keeps to SpanData.
+  static std::vector<SpanData> TakeStoredSpanData(
+      const std::vector<SpanImplPtr>& spans);
+
   // Returns true if the spans_ batch is full.
   bool IsBatchFull() const;
 
+  // With OverflowPolicy::kSampleByTrace, returns true if a span of the trace
+  // should be buffered when 'size' spans already are. Keeps fewer traces as
+  // the buffer fills past half, but never more: see UpdateTraceSampling().
+  bool KeepTrace(const TraceId& trace_id, size_t size, size_t max_spans);
+
+  // Called after draining 'drained' spans. Keeps every trace again once spans
+  // have arrived for a whole interval_ slower than they would fill half the
+  // buffer, so that the traces kept during a burst stay kept until it ends.
+  void UpdateTraceSampling(size_t drained)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(handler_mu_);
+
+  // The worker waits on span_mu_ for a full batch. Producers only take it to
+  // wake the worker, at most once per batch.
   mutable absl::Mutex span_mu_;
   mutable absl::Mutex handler_mu_;
   int batch_size_ ABSL_GUARDED_BY(handler_mu_) = 64;
   absl::Duration interval_ ABSL_GUARDED_BY(handler_mu_) = absl::Seconds(5);
-  // Updated in RunWorkerLoop and protected by span_mu_ instead of handler_mu_.
-  int cached_batch_size_ ABSL_GUARDED_BY(span_mu_);
-  std::vector<std::shared_ptr<opencensus::trace::SpanImpl>> spans_
-      ABSL_GUARDED_BY(span_mu_);
-  std::vector<std::unique_ptr<SpanExporter::Handler>> handlers_
+  // Updated in RunWorkerLoop and read by AddSpan without locking. This is
+  // at most max_spans_, so that a small buffer still wakes the worker.
+  std::atomic<int> cached_batch_size_{64};
+  std::atomic<size_t> max_spans_{SpanExporter::kMaxBufferedSpans};
+  std::atomic<SpanExporter::OverflowPolicy> overflow_policy_{
+      SpanExporter::OverflowPolicy::kDropNewest};
+  // Set by the producer that wakes the worker, cleared by the worker.
+  std::atomic<bool> worker_woken_{false};
+  common::BoundedQueue<SpanImplPtr> spans_;
+  std::atomic<uint64_t> dropped_newest_{0};
+  std::atomic<uint64_t> dropped_oldest_{0};
+  std::atomic<uint64_t> dropped_by_trace_{0};
+  // OverflowPolicy::kSampleByTrace keeps the traces whose TraceId has its
+  // leading trace_shift_ bits zero: one in 2^trace_shift_.
+  std::atomic<int> trace_shift_{0};
+  // dropped_by_trace_ at the last Export().
+  uint64_t exported_dropped_by_trace_ ABSL_GUARDED_BY(handler_mu_) = 0;
+  // The last Export() that drained at least half a buffer's worth of arrivals.
+  absl::Time last_overflow_ ABSL_GUARDED_BY(handler_mu_) =
+      absl::InfinitePast();
+  std::function<void(const SpanExporter::BufferStats&)> buffer_stats_listener_
+      ABSL_GUARDED_BY(handler_mu_);
+  std::function<void()> export_listener_ ABSL_GUARDED_BY(handler_mu_);
+  std::vector<std::unique_ptr<HandlerWorker>> handlers_
       ABSL_GUARDED_BY(handler_mu_);
-  bool thread_started_ ABSL_GUARDED_BY(handler_mu_) = false;
-  // Don't collect spans until an exporter has been registered.
-  bool collect_spans_ ABSL_GUARDED_BY(span_mu_) = false;
-  std::thread t_ ABSL_GUARDED_BY(handler_mu_);
+  // The number of handlers_ that are BatchHandlers.
+  size_t num_batch_handlers_ ABSL_GUARDED_BY(handler_mu_) = 0;
+  std::thread t_;
 };
 
 }  // namespace exporter
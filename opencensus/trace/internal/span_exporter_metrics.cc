@@ -0,0 +1,129 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/exporter/span_exporter_metrics.h"
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "opencensus/stats/stats.h"
+#include "opencensus/tags/tag_key.h"
+#include "opencensus/trace/exporter/span_exporter.h"
+#include "opencensus/trace/internal/span_exporter_impl.h"
+
+namespace opencensus {
+namespace trace {
+namespace exporter {
+
+namespace {
+
+constexpr char kDroppedSpansName[] =
+    "opencensus.io/trace/exporter/dropped_spans";
+constexpr char kBufferedSpansName[] =
+    "opencensus.io/trace/exporter/buffered_spans";
+
+stats::MeasureInt64 DroppedSpansMeasure() {
+  static const stats::MeasureInt64 measure = stats::MeasureInt64::Register(
+      kDroppedSpansName,
+      "Spans dropped from the buffer of spans waiting to be exported.", "1");
+  return measure;
+}
+
+stats::MeasureInt64 BufferedSpansMeasure() {
+  static const stats::MeasureInt64 measure = stats::MeasureInt64::Register(
+      kBufferedSpansName, "Spans waiting to be exported.", "1");
+  return measure;
+}
+
+tags::TagKey ReasonKey() {
+  static const tags::TagKey key = tags::TagKey::Register("reason");
+  return key;
+}
+
+void RecordDropped(uint64_t now, uint64_t before, absl::string_view reason) {
+  if (now > before) {
+    stats::Record({{DroppedSpansMeasure(), static_cast<int64_t>(now - before)}},
+                  {{ReasonKey(), reason}});
+  }
+}
+
+// Records the change since the previous call. The SpanExporter calls it from
+// one thread at a time.
+class Recorder {
+ public:
+  Recorder() : last_(SpanExporter::GetBufferStats()) {}
+
+  void operator()(const SpanExporter::BufferStats& stats) {
+    stats::Record({{BufferedSpansMeasure(),
+                    static_cast<int64_t>(stats.buffered_spans)}});
+    RecordDropped(stats.dropped_newest, last_.dropped_newest, "drop_newest");
+    RecordDropped(stats.dropped_oldest, last_.dropped_oldest, "drop_oldest");
+    RecordDropped(stats.dropped_by_trace, last_.dropped_by_trace,
+                  "sample_by_trace");
+    last_ = stats;
+  }
+
+ private:
+  SpanExporter::BufferStats last_;
+};
+
+}  // namespace
+
+// static
+void SpanExporterMetrics::Enable() {
+  static const bool enabled = [] {
+    SpanExporterImpl::Get()->SetBufferStatsListener(Recorder());
+    return true;
+  }();
+  (void)enabled;
+}
+
+// static
+void SpanExporterMetrics::RegisterViewsForExport() {
+  Enable();
+  DroppedSpansView().RegisterForExport();
+  BufferedSpansView().RegisterForExport();
+}
+
+// static
+const stats::ViewDescriptor& SpanExporterMetrics::DroppedSpansView() {
+  DroppedSpansMeasure();  // The view needs the measure to be registered.
+  static const stats::ViewDescriptor* const descriptor =
+      new stats::ViewDescriptor(
+          stats::ViewDescriptor()
+              .set_name(kDroppedSpansName)
+              .set_measure(kDroppedSpansName)
+              .set_aggregation(stats::Aggregation::Sum())
+              .add_column(ReasonKey())
+              .set_description("Spans dropped from the buffer of spans "
+                               "waiting to be exported, by reason."));
+  return *descriptor;
+}
+
+// static
+const stats::ViewDescriptor& SpanExporterMetrics::BufferedSpansView() {
+  BufferedSpansMeasure();
+  static const stats::ViewDescriptor* const descriptor =
+      new stats::ViewDescriptor(
+          stats::ViewDescriptor()
+              .set_name(kBufferedSpansName)
+              .set_measure(kBufferedSpansName)
+              .set_aggregation(stats::Aggregation::LastValue())
+              .set_description("Spans waiting to be exported."));
+  return *descriptor;
+}
+
+}  // namespace exporter
+}  // namespace trace
+}  // namespace opencensus
@@ -0,0 +1,75 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/exporter/span_exporter_metrics.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "opencensus/stats/stats.h"
+#include "opencensus/stats/testing/test_utils.h"
+#include "opencensus/trace/exporter/span_exporter.h"
+#include "opencensus/trace/sampler.h"
+#include "opencensus/trace/span.h"
+
+namespace opencensus {
+namespace trace {
+
+namespace exporter {
+class SpanExporterTestPeer {
+ public:
+  static constexpr auto& ExportForTesting = SpanExporter::ExportForTesting;
+};
+}  // namespace exporter
+
+namespace {
+
+TEST(SpanExporterMetricsTest, RecordsDroppedSpans) {
+  exporter::SpanExporterMetrics::Enable();
+  stats::View dropped(exporter::SpanExporterMetrics::DroppedSpansView());
+  stats::View buffered(exporter::SpanExporterMetrics::BufferedSpansView());
+  ASSERT_TRUE(dropped.IsValid());
+  ASSERT_TRUE(buffered.IsValid());
+  const uint64_t dropped_before =
+      exporter::SpanExporter::GetBufferStats().dropped_newest;
+
+  exporter::SpanExporter::BufferOptions options;
+  options.max_spans = 1;
+  exporter::SpanExporter::SetBufferOptions(options);
+  AlwaysSampler sampler;
+  for (int i = 0; i < 100; ++i) {
+    Span::StartSpan("Span", nullptr, {&sampler}).End();
+  }
+  exporter::SpanExporterTestPeer::ExportForTesting();
+  stats::testing::TestUtils::Flush();
+
+  const uint64_t dropped_spans =
+      exporter::SpanExporter::GetBufferStats().dropped_newest - dropped_before;
+  EXPECT_GT(dropped_spans, 0);
+  const auto dropped_data = dropped.GetData();
+  ASSERT_EQ(stats::ViewData::Type::kInt64, dropped_data.type());
+  EXPECT_EQ(dropped_spans, dropped_data.int_data().at(
+                               std::vector<std::string>{"drop_newest"}));
+  const auto buffered_data = buffered.GetData();
+  ASSERT_EQ(stats::ViewData::Type::kInt64, buffered_data.type());
+  EXPECT_EQ(0, buffered_data.int_data().at(std::vector<std::string>{}));
+  exporter::SpanExporter::SetBufferOptions(
+      exporter::SpanExporter::BufferOptions());
+}
+
+}  // namespace
+}  // namespace trace
+}  // namespace opencensus
@@ -14,17 +14,32 @@
 
 #include "opencensus/trace/exporter/span_exporter.h"
 
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
 #include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "gtest/gtest.h"
 #include "opencensus/trace/exporter/span_data.h"
+#include "opencensus/trace/internal/span_exporter_impl.h"
 #include "opencensus/trace/sampler.h"
 #include "opencensus/trace/span.h"
 
 namespace opencensus {
 namespace trace {
+
+namespace exporter {
+class SpanExporterTestPeer {
+ public:
+  static constexpr auto& ExportForTesting = SpanExporter::ExportForTesting;
+};
+}  // namespace exporter
+
 namespace {
 
 class Counter {
@@ -61,6 +76,70 @@ class MyExporter : public exporter::SpanExporter::Handler {
   }
 };
 
+// Blocks in Export() until released.
+class BlockingExporter : public exporter::SpanExporter::Handler {
+ public:
+  static absl::Notification* release() {
+    static absl::Notification* global_release = new absl::Notification;
+    return global_release;
+  }
+
+  void Export(const std::vector<exporter::SpanData>& spans) override {
+    release()->WaitForNotification();
+  }
+};
+
+exporter::SpanExporter::HandlerStats GetHandlerStats(absl::string_view name) {
+  for (const auto& stats : exporter::SpanExporter::GetHandlerStats()) {
+    if (stats.name == name) return stats;
+  }
+  ADD_FAILURE() << "No handler named " << name;
+  return {};
+}
+
+// Blocks the exporter worker for its lifetime, so that ended spans stay in the
+// buffer.
+class WorkerBlocker {
+ public:
+  WorkerBlocker() {
+    exporter::SpanExporterImpl::Get()->SetBufferStatsListener(
+        [this](const exporter::SpanExporter::BufferStats&) {
+          if (!blocked_.HasBeenNotified()) {
+            blocked_.Notify();
+            release_.WaitForNotification();
+          }
+        });
+    // With a batch size of 1, one span wakes the worker.
+    AlwaysSampler sampler;
+    Span::StartSpan("Trigger", nullptr, {&sampler}).End();
+    blocked_.WaitForNotification();
+  }
+
+  ~WorkerBlocker() {
+    Release();
+    exporter::SpanExporterImpl::Get()->SetBufferStatsListener(nullptr);
+    exporter::SpanExporter::SetBufferOptions(
+        exporter::SpanExporter::BufferOptions());
+  }
+
+  // Lets the worker export again, without resetting the buffer options.
+  void Release() {
+    if (!release_.HasBeenNotified()) release_.Notify();
+  }
+
+ private:
+  absl::Notification blocked_;
+  absl::Notification release_;
+};
+
+// Ends n sampled root spans.
+void EndSpans(int n) {
+  AlwaysSampler sampler;
+  for (int i = 0; i < n; ++i) {
+    Span::StartSpan("Span", nullptr, {&sampler}).End();
+  }
+}
+
 class SpanExporterTest : public ::testing::Test {
  protected:
   static void SetUpTestSuite() {
@@ -69,6 +148,8 @@ class SpanExporterTest : public ::testing::Test {
 
     // Only register once.
     MyExporter::Register();
+    exporter::SpanExporter::RegisterHandler(
+        absl::make_unique<BlockingExporter>(), "blocking");
   }
 };
 
@@ -92,6 +173,145 @@ TEST_F(SpanExporterTest, BasicExportTest) {
   EXPECT_EQ(3, Counter::Get()->value());
 }
 
+TEST_F(SpanExporterTest, SlowHandlerDoesNotDelayOthers) {
+  ::opencensus::trace::AlwaysSampler sampler;
+  const int exported_before = Counter::Get()->value();
+  // Enough spans to overflow the queue of the blocked handler.
+  for (size_t i = 0; i < 2 * exporter::SpanExporter::kHandlerQueueCapacity;
+       ++i) {
+    ::opencensus::trace::Span::StartSpan("Span", nullptr, {&sampler}).End();
+  }
+
+  for (int i = 0; i < 100; ++i) {
+    if (Counter::Get()->value() > exported_before &&
+        GetHandlerStats("blocking").dropped_spans > 0) {
+      break;
+    }
+    absl::SleepFor(absl::Milliseconds(100));
+  }
+  EXPECT_GT(Counter::Get()->value(), exported_before)
+      << "Other handlers keep exporting.";
+  const auto blocked_stats = GetHandlerStats("blocking");
+  EXPECT_GT(blocked_stats.dropped_spans, 0);
+  EXPECT_GT(blocked_stats.queued_batches, 0);
+  EXPECT_EQ(0, GetHandlerStats("").dropped_spans);
+
+  absl::SleepFor(absl::Milliseconds(20));
+  BlockingExporter::release()->Notify();
+  exporter::SpanExporterTestPeer::ExportForTesting();
+  const auto released_stats = GetHandlerStats("blocking");
+  EXPECT_EQ(0, released_stats.queued_batches);
+  EXPECT_GT(released_stats.exported_spans, 0);
+  // The first Export() call was blocked for at least 20ms.
+  uint64_t slow_exports = 0;
+  for (size_t i = 4; i < exporter::SpanExporter::kNumExportLatencyBuckets;
+       ++i) {
+    slow_exports += released_stats.export_latency_counts[i];
+  }
+  EXPECT_GE(slow_exports, 1);
+}
+
+TEST_F(SpanExporterTest, BufferDropsNewestWhenFull) {
+  WorkerBlocker blocker;
+  exporter::SpanExporter::BufferOptions options;
+  options.max_spans = 4;
+  options.overflow_policy =
+      exporter::SpanExporter::OverflowPolicy::kDropNewest;
+  exporter::SpanExporter::SetBufferOptions(options);
+  const auto before = exporter::SpanExporter::GetBufferStats();
+  EndSpans(10);
+  const auto after = exporter::SpanExporter::GetBufferStats();
+  EXPECT_EQ(4, after.buffered_spans);
+  EXPECT_EQ(6, after.dropped_newest - before.dropped_newest);
+  EXPECT_EQ(0, after.dropped_oldest - before.dropped_oldest);
+}
+
+TEST_F(SpanExporterTest, BufferDropsOldestWhenFull) {
+  WorkerBlocker blocker;
+  exporter::SpanExporter::BufferOptions options;
+  options.max_spans = 4;
+  options.overflow_policy =
+      exporter::SpanExporter::OverflowPolicy::kDropOldest;
+  exporter::SpanExporter::SetBufferOptions(options);
+  const auto before = exporter::SpanExporter::GetBufferStats();
+  EndSpans(10);
+  const auto after = exporter::SpanExporter::GetBufferStats();
+  EXPECT_EQ(4, after.buffered_spans);
+  EXPECT_EQ(0, after.dropped_newest - before.dropped_newest);
+  EXPECT_EQ(6, after.dropped_oldest - before.dropped_oldest);
+}
+
+// Waits until the worker has taken every buffered span.
+bool WaitForEmptyBuffer() {
+  for (int i = 0; i < 1000; ++i) {
+    if (exporter::SpanExporter::GetBufferStats().buffered_spans == 0) {
+      return true;
+    }
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  return false;
+}
+
+// Ends a child span of each root, and returns whether it was buffered. If
+// 'one_at_a_time', waits for each child to be exported so that the buffer
+// stays nearly empty.
+std::vector<bool> EndChildren(const std::vector<Span>& roots,
+                              bool one_at_a_time) {
+  std::vector<bool> kept;
+  for (const auto& root : roots) {
+    const uint64_t dropped =
+        exporter::SpanExporter::GetBufferStats().dropped_by_trace;
+    Span::StartSpan("Child", &root).End();
+    kept.push_back(exporter::SpanExporter::GetBufferStats().dropped_by_trace ==
+                   dropped);
+    if (one_at_a_time) {
+      EXPECT_TRUE(WaitForEmptyBuffer());
+    }
+  }
+  return kept;
+}
+
+TEST_F(SpanExporterTest, BufferSamplesByTraceWhenHalfFull) {
+  AlwaysSampler sampler;
+  std::vector<Span> roots;
+  for (int i = 0; i < 100; ++i) {
+    roots.push_back(Span::StartSpan("Root", nullptr, {&sampler}));
+  }
+  WorkerBlocker blocker;
+  exporter::SpanExporter::BufferOptions options;
+  options.max_spans = 100;
+  options.overflow_policy =
+      exporter::SpanExporter::OverflowPolicy::kSampleByTrace;
+  exporter::SpanExporter::SetBufferOptions(options);
+  const auto before = exporter::SpanExporter::GetBufferStats();
+  const std::vector<bool> kept_while_filling =
+      EndChildren(roots, /*one_at_a_time=*/false);
+  const auto after = exporter::SpanExporter::GetBufferStats();
+  EXPECT_GE(after.buffered_spans, 50);
+  EXPECT_LT(after.buffered_spans, 100);
+  EXPECT_EQ(100 - after.buffered_spans,
+            after.dropped_by_trace - before.dropped_by_trace);
+
+  // Once the buffer drains, the traces that were dropped stay dropped, and
+  // the same traces are kept each time.
+  blocker.Release();
+  ASSERT_TRUE(WaitForEmptyBuffer());
+  const std::vector<bool> kept_after_drain =
+      EndChildren(roots, /*one_at_a_time=*/true);
+  EXPECT_EQ(kept_after_drain, EndChildren(roots, /*one_at_a_time=*/true));
+  int dropped_traces = 0;
+  for (size_t i = 0; i < roots.size(); ++i) {
+    if (!kept_while_filling[i]) {
+      ++dropped_traces;
+      EXPECT_FALSE(kept_after_drain[i]) << "Trace " << i << " was dropped.";
+    }
+  }
+  EXPECT_GT(dropped_traces, 0);
+  for (auto& root : roots) {
+    root.End();
+  }
+}
+
 }  // namespace
 }  // namespace trace
 }  // namespace opencensus
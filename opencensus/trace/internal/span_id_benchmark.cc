@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "benchmark/benchmark.h"
+#include "opencensus/common/internal/random.h"
 #include "opencensus/trace/span_id.h"
 
 namespace opencensus {
@@ -79,6 +80,18 @@ void BM_SpanIdCopyTo(benchmark::State& state) {
 }
 BENCHMARK(BM_SpanIdCopyTo);
 
+// Generates SpanIds the way Span::StartSpan does, from many threads at once.
+void BM_SpanIdGenerateRandom(benchmark::State& state) {
+  uint8_t buf[SpanId::kSize];
+  for (auto _ : state) {
+    ::opencensus::common::Random::GetRandom()->GenerateRandomBuffer(
+        buf, SpanId::kSize);
+    SpanId id(buf);
+    benchmark::DoNotOptimize(id);
+  }
+}
+BENCHMARK(BM_SpanIdGenerateRandom)->ThreadRange(1, 16);
+
 }  // namespace
 }  // namespace trace
 }  // namespace opencensus
@@ -14,15 +14,23 @@
 
 #include "opencensus/trace/internal/span_impl.h"
 
-#include <deque>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "absl/time/clock.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "opencensus/common/internal/clock.h"
 #include "opencensus/trace/attribute_value_ref.h"
 #include "opencensus/trace/exporter/attribute_value.h"
 #include "opencensus/trace/exporter/message_event.h"
+#include "opencensus/trace/exporter/span_batch.h"
 #include "opencensus/trace/internal/local_span_store_impl.h"
 #include "opencensus/trace/internal/running_span_store_impl.h"
 #include "opencensus/trace/internal/span_exporter_impl.h"
@@ -32,53 +40,258 @@ namespace opencensus {
 namespace trace {
 
 namespace {
-template <typename T>
-std::vector<T> CopyTraceEvents(const std::deque<T>& events) {
-  std::vector<T> trace_events;
-  trace_events.reserve(events.size());
-  for (const auto& event : events) {
-    trace_events.emplace_back(event);
-  }
-  return trace_events;
+// The arena is compacted once it holds at least this much.
+constexpr size_t kMinCompactBytes = 8 * 1024;
+
+using MessageEvents =
+    std::vector<exporter::SpanData::TimeEvent<exporter::MessageEvent>>;
+
+// Converts Clock ticks to nanoseconds since the Unix epoch, for SpanBatch.
+int64_t ToUnixNanos(int64_t ticks) {
+  return absl::ToUnixNanos(common::Clock::ToTime(ticks));
 }
 
-template <typename T>
-std::vector<exporter::SpanData::TimeEvent<T>> CopyEventWithTime(
-    const std::deque<EventWithTime<T>>& events) {
-  std::vector<exporter::SpanData::TimeEvent<T>> time_events;
+MessageEvents CopyMessageEvents(
+    const TraceEvents<EventWithTime<exporter::MessageEvent>>& events) {
+  MessageEvents time_events;
   time_events.reserve(events.size());
-  for (const auto& event : events) {
+  events.ForEach([&time_events](
+                     const EventWithTime<exporter::MessageEvent>& event) {
     auto tmp_event = event.event;
-    time_events.emplace_back(event.time, std::move(tmp_event));
-  }
+    time_events.emplace_back(common::Clock::ToTime(event.time),
+                             std::move(tmp_event));
+  });
+  return time_events;
+}
+
+MessageEvents TakeMessageEvents(
+    TraceEvents<EventWithTime<exporter::MessageEvent>>* events) {
+  MessageEvents time_events;
+  time_events.reserve(events->size());
+  events->Take([&time_events](EventWithTime<exporter::MessageEvent>&& event) {
+    time_events.emplace_back(common::Clock::ToTime(event.time),
+                             std::move(event.event));
+  });
   return time_events;
 }
 
-// Deep-copies an initializer_list of absl::string_view keys and
-// AttributeValueRefs (cheap, used in the API) to an unordered_map that owns all
-// of the data in it. If the same key appears multiple times, the last value
-// wins.
-std::unordered_map<std::string, exporter::AttributeValue> CopyAttributes(
-    AttributesRef attributes) {
-  std::unordered_map<std::string, exporter::AttributeValue> out;
-  for (const auto& pair : attributes) {
-    auto iter_inserted = out.insert(
-        {std::string(pair.first), exporter::AttributeValue(pair.second)});
-    if (!iter_inserted.second) {
-      // Already exists, update.
-      iter_inserted.first->second = exporter::AttributeValue(pair.second);
+// SpanImplPool recycles the storage of SpanImpls, together with the first
+// block of their Arena, so that starting a span usually allocates nothing.
+// Each thread keeps its own free list. Spans are mostly released by the
+// exporter thread, so a thread whose list grows too long hands slots off in
+// batches through a global list, from which other threads refill theirs. The
+// global list is bounded by the memory it holds, so that a burst of spans
+// does not leave the pool holding a lot of memory afterwards.
+class SpanImplPool final {
+ public:
+  // Returns storage for a SpanImpl, and sets *arena to a recycled Arena if
+  // there is one.
+  static void* Allocate(common::Arena* arena);
+
+  // Returns the storage of a destroyed SpanImpl, and its Arena, to the pool.
+  static void Release(void* storage, common::Arena arena);
+
+ private:
+  // A free slot is constructed in the storage of a destroyed SpanImpl.
+  struct FreeSlot {
+    FreeSlot* next;
+    common::Arena arena;
+  };
+  static_assert(sizeof(FreeSlot) <= sizeof(SpanImpl), "");
+  static_assert(alignof(FreeSlot) <= alignof(SpanImpl), "");
+
+  struct Batch {
+    FreeSlot* head;
+    size_t size;
+  };
+
+  // A Batch in the global list, with the memory it holds.
+  struct GlobalBatch {
+    Batch batch;
+    size_t bytes;
+  };
+
+  struct LocalPool {
+    ~LocalPool();
+    Batch slots = {nullptr, 0};
+  };
+
+  // Slots are moved to and from the global list in batches of this size.
+  static constexpr size_t kBatchSize = 64;
+  // A thread keeps at most this many free slots.
+  static constexpr size_t kMaxLocalSlots = 2 * kBatchSize;
+  // The global list holds batches of at most this many bytes in total,
+  // counting SpanImpls and their Arenas' blocks.
+  static constexpr size_t kMaxGlobalBytes = 4 * 1024 * 1024;
+  // Arenas that have grown beyond this are not kept.
+  static constexpr size_t kMaxPooledArenaBytes = 4 * 1024;
+
+  // Returns this thread's pool, or nullptr if it has already been destroyed
+  // during thread exit.
+  static LocalPool* Local();
+
+  static absl::Mutex* global_mu();
+  static std::vector<GlobalBatch>* global_batches()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(global_mu());
+  static size_t* global_bytes() ABSL_EXCLUSIVE_LOCKS_REQUIRED(global_mu());
+
+  static void PushGlobal(Batch batch);
+  static Batch PopGlobal();
+  static void FreeSlots(FreeSlot* head);
+  // Returns the memory held by the slots starting at head.
+  static size_t SlotBytes(const FreeSlot* head);
+};
+
+constexpr size_t SpanImplPool::kBatchSize;
+constexpr size_t SpanImplPool::kMaxLocalSlots;
+constexpr size_t SpanImplPool::kMaxGlobalBytes;
+constexpr size_t SpanImplPool::kMaxPooledArenaBytes;
+
+// Trivially destructible, so it is still valid while thread_local objects
+// with destructors are being destroyed.
+thread_local bool local_pool_destroyed = false;
+
+SpanImplPool::LocalPool::~LocalPool() {
+  local_pool_destroyed = true;
+  if (slots.head != nullptr) PushGlobal(slots);
+}
+
+SpanImplPool::LocalPool* SpanImplPool::Local() {
+  if (local_pool_destroyed) return nullptr;
+  static thread_local LocalPool pool;
+  return &pool;
+}
+
+absl::Mutex* SpanImplPool::global_mu() {
+  static absl::Mutex* mu = new absl::Mutex;
+  return mu;
+}
+
+std::vector<SpanImplPool::GlobalBatch>* SpanImplPool::global_batches() {
+  static std::vector<GlobalBatch>* batches = new std::vector<GlobalBatch>;
+  return batches;
+}
+
+size_t* SpanImplPool::global_bytes() {
+  static size_t bytes = 0;
+  return &bytes;
+}
+
+void SpanImplPool::PushGlobal(Batch batch) {
+  const size_t bytes = SlotBytes(batch.head);
+  {
+    absl::MutexLock l(global_mu());
+    if (*global_bytes() + bytes <= kMaxGlobalBytes) {
+      global_batches()->push_back({batch, bytes});
+      *global_bytes() += bytes;
+      return;
     }
   }
-  return out;
+  FreeSlots(batch.head);
+}
+
+SpanImplPool::Batch SpanImplPool::PopGlobal() {
+  absl::MutexLock l(global_mu());
+  if (global_batches()->empty()) return Batch{nullptr, 0};
+  const GlobalBatch global_batch = global_batches()->back();
+  global_batches()->pop_back();
+  *global_bytes() -= global_batch.bytes;
+  return global_batch.batch;
+}
+
+void SpanImplPool::FreeSlots(FreeSlot* head) {
+  while (head != nullptr) {
+    FreeSlot* next = head->next;
+    head->~FreeSlot();
+    ::operator delete(head);
+    head = next;
+  }
+}
+
+size_t SpanImplPool::SlotBytes(const FreeSlot* head) {
+  size_t bytes = 0;
+  for (; head != nullptr; head = head->next) {
+    bytes += sizeof(SpanImpl) + head->arena.bytes_reserved();
+  }
+  return bytes;
 }
+
+void* SpanImplPool::Allocate(common::Arena* arena) {
+  LocalPool* pool = Local();
+  if (pool != nullptr) {
+    if (pool->slots.head == nullptr) pool->slots = PopGlobal();
+    FreeSlot* slot = pool->slots.head;
+    if (slot != nullptr) {
+      pool->slots.head = slot->next;
+      --pool->slots.size;
+      *arena = std::move(slot->arena);
+      slot->~FreeSlot();
+      return slot;
+    }
+  }
+  return ::operator new(sizeof(SpanImpl));
+}
+
+void SpanImplPool::Release(void* storage, common::Arena arena) {
+  LocalPool* pool = Local();
+  if (pool == nullptr) {
+    ::operator delete(storage);
+    return;
+  }
+  if (arena.bytes_reserved() > kMaxPooledArenaBytes) {
+    arena = common::Arena();
+  } else {
+    arena.Reset();
+  }
+  pool->slots.head =
+      new (storage) FreeSlot{pool->slots.head, std::move(arena)};
+  if (++pool->slots.size > kMaxLocalSlots) {
+    // Hand the most recently freed batch off to other threads.
+    Batch batch = {pool->slots.head, kBatchSize};
+    FreeSlot* last = batch.head;
+    for (size_t i = 1; i < kBatchSize; ++i) last = last->next;
+    pool->slots.head = last->next;
+    pool->slots.size -= kBatchSize;
+    last->next = nullptr;
+    PushGlobal(batch);
+  }
+}
+
 }  // namespace
 
-// SpanImpl::SpanImpl() : has_ended_(false), remote_parent_(false) {}
+void IntrusiveRef(SpanImpl* span) {
+  span->ref_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+// The last reference is being dropped, so nothing else can hold mu_.
+void IntrusiveUnref(SpanImpl* span) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+  if (span->ref_count_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+  common::Arena arena = std::move(span->arena_);
+  span->~SpanImpl();
+  SpanImplPool::Release(span, std::move(arena));
+}
+
+SpanImplPtr SpanImpl::Create(const SpanContext& context,
+                             const TraceParams& trace_params,
+                             absl::string_view name,
+                             const SpanId& parent_span_id,
+                             bool remote_parent) {
+  common::Arena arena;
+  void* storage = SpanImplPool::Allocate(&arena);
+  return SpanImplPtr::Adopt(new (storage)
+                                SpanImpl(context, trace_params, name,
+                                         parent_span_id, remote_parent,
+                                         std::move(arena)));
+}
 
 SpanImpl::SpanImpl(const SpanContext& context, const TraceParams& trace_params,
                    absl::string_view name, const SpanId& parent_span_id,
-                   bool remote_parent)
-    : start_time_(absl::Now()),
+                   bool remote_parent, common::Arena arena)
+    : ref_count_(1),
+      arena_(std::move(arena)),
+      compact_threshold_(kMinCompactBytes),
+      start_time_(common::Clock::NowTicks()),
+      end_time_(0),
       name_(name),
       parent_span_id_(parent_span_id),
       context_(context),
@@ -93,9 +306,9 @@ void SpanImpl::AddAttributes(AttributesRef attributes) {
   absl::MutexLock l(&mu_);
   if (!has_ended_) {
     for (const auto& attr : attributes) {
-      attributes_.AddAttribute(attr.first,
-                               exporter::AttributeValue(attr.second));
+      attributes_.AddAttribute(attr.first, attr.second, &arena_);
     }
+    MaybeCompactArena();
   }
 }
 
@@ -103,9 +316,11 @@ void SpanImpl::AddAnnotation(absl::string_view description,
                              AttributesRef attributes) {
   absl::MutexLock l(&mu_);
   if (!has_ended_) {
-    annotations_.AddEvent(EventWithTime<exporter::Annotation>(
-        absl::Now(),
-        exporter::Annotation(description, CopyAttributes(attributes))));
+    annotations_.AddEvent(EventWithTime<AnnotationRecord>(
+        common::Clock::NowTicks(),
+        AnnotationRecord{CopyString(description, &arena_),
+                         CopyAttributes(attributes, &arena_)}));
+    MaybeCompactArena();
   }
 }
 
@@ -116,7 +331,7 @@ void SpanImpl::AddMessageEvent(exporter::MessageEvent::Type type,
   absl::MutexLock l(&mu_);
   if (!has_ended_) {
     message_events_.AddEvent(EventWithTime<exporter::MessageEvent>(
-        absl::Now(),
+        common::Clock::NowTicks(),
         exporter::MessageEvent(type, message_id, compressed_message_size,
                                uncompressed_message_size)));
   }
@@ -126,8 +341,29 @@ void SpanImpl::AddLink(const SpanContext& context, exporter::Link::Type type,
                        AttributesRef attributes) {
   absl::MutexLock l(&mu_);
   if (!has_ended_) {
-    links_.AddEvent(exporter::Link(context, type, CopyAttributes(attributes)));
+    links_.AddEvent(
+        LinkRecord{context, type, CopyAttributes(attributes, &arena_)});
+    MaybeCompactArena();
+  }
+}
+
+void SpanImpl::MaybeCompactArena() {
+  if (arena_.bytes_allocated() < compact_threshold_) {
+    return;
   }
+  common::Arena arena;
+  attributes_.MoveTo(&arena);
+  annotations_.ForEachMutable(
+      [&arena](EventWithTime<AnnotationRecord>& event) {
+        event.event.description = CopyString(event.event.description, &arena);
+        event.event.attributes =
+            CopyAttributes(event.event.attributes, &arena);
+      });
+  links_.ForEachMutable([&arena](LinkRecord& link) {
+    link.attributes = CopyAttributes(link.attributes, &arena);
+  });
+  arena_ = std::move(arena);
+  compact_threshold_ = std::max(kMinCompactBytes, 2 * arena_.bytes_allocated());
 }
 
 void SpanImpl::SetStatus(exporter::Status&& status) {
@@ -144,7 +380,7 @@ void SpanImpl::SetName(absl::string_view name) {
   }
 }
 
-bool SpanImpl::End() {
+bool SpanImpl::End(EndedSpan* ended) {
   absl::MutexLock l(&mu_);
   if (has_ended_) {
     assert(false && "Invalid attempt to End() the same Span more than once.");
@@ -152,7 +388,10 @@ bool SpanImpl::End() {
     return false;
   }
   has_ended_ = true;
-  end_time_ = absl::Now();
+  end_time_ = common::Clock::NowTicks();
+  if (ended != nullptr) {
+    *ended = EndedSpanLocked();
+  }
   return true;
 }
 
@@ -166,22 +405,130 @@ std::string SpanImpl::name() const {
   return name_;
 }
 
+StatusCode SpanImpl::status_code() const {
+  absl::MutexLock l(&mu_);
+  return status_.CanonicalCode();
+}
+
+absl::Duration SpanImpl::latency() const {
+  absl::MutexLock l(&mu_);
+  return common::Clock::ToDuration(start_time_, end_time_);
+}
+
+SpanImpl::EndedSpan SpanImpl::GetEndedSpan() const {
+  absl::MutexLock l(&mu_);
+  return EndedSpanLocked();
+}
+
+SpanImpl::EndedSpan SpanImpl::EndedSpanLocked() const {
+  return {name_, status_.CanonicalCode(), end_time_ - start_time_};
+}
+
 exporter::SpanData SpanImpl::ToSpanData() const {
   absl::MutexLock l(&mu_);
-  // Make a deep copy of attributes.
-  std::unordered_map<std::string, exporter::AttributeValue> attributes =
-      attributes_.attributes();
+  return MakeSpanData(name_, status_, CopyMessageEvents(message_events_));
+}
+
+exporter::SpanData SpanImpl::TakeSpanData() {
+  if (ref_count_.load(std::memory_order_acquire) != 1) {
+    return ToSpanData();
+  }
+  absl::MutexLock l(&mu_);
+  // Nothing else can read the span any more, so its contents can be moved out
+  // rather than copied.
+  return MakeSpanData(std::move(name_), std::move(status_),
+                      TakeMessageEvents(&message_events_));
+}
+
+void SpanImpl::AppendTo(exporter::SpanBatch* batch) const {
+  absl::MutexLock l(&mu_);
+  batch->trace_ids_.push_back(context_.trace_id());
+  batch->span_ids_.push_back(context_.span_id());
+  batch->trace_options_.push_back(context_.trace_options());
+  batch->parent_span_ids_.push_back(parent_span_id_);
+  batch->has_remote_parent_.push_back(remote_parent_);
+  batch->names_.push_back(batch->AddString(name_));
+  batch->start_times_.push_back(ToUnixNanos(start_time_));
+  batch->end_times_.push_back(ToUnixNanos(end_time_));
+  batch->status_codes_.push_back(status_.CanonicalCode());
+  batch->status_messages_.push_back(
+      batch->AddString(status_.error_message()));
+  batch->attribute_ranges_.push_back(
+      batch->AddAttributes(attributes_.attributes()));
+  batch->num_attributes_dropped_.push_back(
+      attributes_.num_attributes_dropped());
+
+  exporter::SpanBatch::Range range;
+  range.begin = static_cast<uint32_t>(batch->annotations_.size());
+  annotations_.ForEach([batch](const EventWithTime<AnnotationRecord>& event) {
+    exporter::SpanBatch::Annotation annotation;
+    annotation.time = ToUnixNanos(event.time);
+    annotation.description = batch->AddString(event.event.description);
+    annotation.attributes = batch->AddAttributes(event.event.attributes);
+    batch->annotations_.push_back(annotation);
+  });
+  range.end = static_cast<uint32_t>(batch->annotations_.size());
+  batch->annotation_ranges_.push_back(range);
+  batch->num_annotations_dropped_.push_back(
+      annotations_.num_events_dropped());
+
+  range.begin = static_cast<uint32_t>(batch->message_events_.size());
+  message_events_.ForEach(
+      [batch](const EventWithTime<exporter::MessageEvent>& event) {
+        batch->message_events_.push_back(
+            exporter::SpanBatch::MessageEvent{ToUnixNanos(event.time),
+                                              event.event});
+      });
+  range.end = static_cast<uint32_t>(batch->message_events_.size());
+  batch->message_event_ranges_.push_back(range);
+  batch->num_message_events_dropped_.push_back(
+      message_events_.num_events_dropped());
+
+  range.begin = static_cast<uint32_t>(batch->links_.size());
+  links_.ForEach([batch](const LinkRecord& record) {
+    exporter::SpanBatch::Link link;
+    link.trace_id = record.context.trace_id();
+    link.span_id = record.context.span_id();
+    link.type = record.type;
+    link.attributes = batch->AddAttributes(record.attributes);
+    batch->links_.push_back(link);
+  });
+  range.end = static_cast<uint32_t>(batch->links_.size());
+  batch->link_ranges_.push_back(range);
+  batch->num_links_dropped_.push_back(links_.num_events_dropped());
+}
+
+exporter::SpanData SpanImpl::MakeSpanData(
+    std::string name, exporter::Status status,
+    std::vector<exporter::SpanData::TimeEvent<exporter::MessageEvent>>
+        message_events) const {
+  std::vector<exporter::SpanData::TimeEvent<exporter::Annotation>> annotations;
+  annotations.reserve(annotations_.size());
+  annotations_.ForEach(
+      [&annotations](const EventWithTime<AnnotationRecord>& event) {
+        annotations.emplace_back(
+            common::Clock::ToTime(event.time),
+            exporter::Annotation(event.event.description,
+                                 ToAttributeMap(event.event.attributes)));
+      });
+  std::vector<exporter::Link> links;
+  links.reserve(links_.size());
+  links_.ForEach([&links](const LinkRecord& link) {
+    links.emplace_back(link.context, link.type,
+                       ToAttributeMap(link.attributes));
+  });
   return exporter::SpanData(
-      name_, context_, parent_span_id_,
+      std::move(name), context_, parent_span_id_,
       exporter::SpanData::TimeEvents<exporter::Annotation>(
-          CopyEventWithTime(annotations_.events()),
-          annotations_.num_events_dropped()),
+          std::move(annotations), annotations_.num_events_dropped()),
       exporter::SpanData::TimeEvents<exporter::MessageEvent>(
-          CopyEventWithTime(message_events_.events()),
-          message_events_.num_events_dropped()),
-      CopyTraceEvents(links_.events()), links_.num_events_dropped(),
-      std::move(attributes), attributes_.num_attributes_dropped(), has_ended_,
-      start_time_, end_time_, status_, remote_parent_);
+          std::move(message_events), message_events_.num_events_dropped()),
+      std::move(links), links_.num_events_dropped(),
+      ToAttributeMap(attributes_.attributes()),
+      attributes_.num_attributes_dropped(), has_ended_,
+      common::Clock::ToTime(start_time_),
+      has_ended_ ? common::Clock::ToTime(end_time_) : absl::Time(),
+      std::move(status), remote_parent_);
 }
 
 }  // namespace trace
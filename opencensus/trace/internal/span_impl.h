@@ -15,17 +15,23 @@
 #ifndef OPENCENSUS_TRACE_INTERNAL_SPAN_IMPL_H_
 #define OPENCENSUS_TRACE_INTERNAL_SPAN_IMPL_H_
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "opencensus/common/internal/arena.h"
 #include "opencensus/trace/exporter/annotation.h"
 #include "opencensus/trace/exporter/attribute_value.h"
 #include "opencensus/trace/exporter/link.h"
 #include "opencensus/trace/exporter/message_event.h"
+#include "opencensus/trace/exporter/span_batch.h"
 #include "opencensus/trace/exporter/span_data.h"
 #include "opencensus/trace/exporter/status.h"
 #include "opencensus/trace/internal/attribute_list.h"
@@ -34,6 +40,8 @@
 #include "opencensus/trace/span.h"
 #include "opencensus/trace/span_context.h"
 #include "opencensus/trace/span_id.h"
+#include "opencensus/trace/span_impl_ptr.h"
+#include "opencensus/trace/status_code.h"
 #include "opencensus/trace/trace_config.h"
 #include "opencensus/trace/trace_params.h"
 
@@ -41,19 +49,25 @@ namespace opencensus {
 namespace trace {
 
 namespace exporter {
-class LocalSpanStoreImpl;
 class RunningSpanStoreImpl;
 class SpanExporterImpl;
 }  // namespace exporter
 
 class SpanTestPeer;
 
-// SpanImpl is the underlying representation of a Span. Span has a shared_ptr
+// SpanImpl is the underlying representation of a Span. Span has a SpanImplPtr
 // that points to a SpanImpl. Multiple Spans, stores, and exporters can share
-// a single SpanImpl.
+// a single SpanImpl. SpanImpls are created by Create() from thread-local pools,
+// and are returned to them, along with their Arena, when the last SpanImplPtr
+// is dropped.
 //
 // This is not a public API, please refer to ../span.h.
 //
+// Attributes, annotation descriptions and link attributes are copied into a
+// per-span Arena, so recording them does not allocate once the Arena has room.
+// They are converted to the exporter types by ToSpanData() and TakeSpanData(),
+// or appended to a SpanBatch by AppendTo().
+//
 // SpanImpl is thread-safe.
 class SpanImpl final {
  public:
@@ -67,9 +81,10 @@ class SpanImpl final {
   // TraceParams sets the maximum number of attributes, annotations, network
   // events, and links. The name allows for a user provided description of the
   // span.
-  SpanImpl(const SpanContext& context, const TraceParams& trace_params,
-           absl::string_view name, const SpanId& parent_span_id,
-           bool remote_parent);
+  static SpanImplPtr Create(const SpanContext& context,
+                            const TraceParams& trace_params,
+                            absl::string_view name,
+                            const SpanId& parent_span_id, bool remote_parent);
 
   void AddAttributes(AttributesRef attributes) ABSL_LOCKS_EXCLUDED(mu_);
 
@@ -87,9 +102,19 @@ class SpanImpl final {
 
   void SetName(absl::string_view name) ABSL_LOCKS_EXCLUDED(mu_);
 
+  // What End() reports about the span, for SpanCounts. The name stays valid
+  // while the caller holds a reference to the span, since an ended span cannot
+  // be renamed.
+  struct EndedSpan {
+    absl::string_view name;
+    StatusCode status_code;
+    int64_t latency_ticks;
+  };
+
   // Returns true on success (if this is the first time the Span has ended) and
-  // also marks the end of the Span and sets its end_time_.
-  bool End() ABSL_LOCKS_EXCLUDED(mu_);
+  // also marks the end of the Span and sets its end_time_. On success, if
+  // 'ended' is not null, it is filled in.
+  bool End(EndedSpan* ended = nullptr) ABSL_LOCKS_EXCLUDED(mu_);
 
   // Returns true if the span has ended.
   bool HasEnded() const ABSL_LOCKS_EXCLUDED(mu_);
@@ -103,20 +128,80 @@ class SpanImpl final {
 
   SpanId parent_span_id() const { return parent_span_id_; }
 
+  // Returns true if the parent of this span is in another process.
+  bool remote_parent() const { return remote_parent_; }
+
+  StatusCode status_code() const ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the time from the start to the end of an ended span.
+  absl::Duration latency() const ABSL_LOCKS_EXCLUDED(mu_);
+
  private:
   friend class ::opencensus::trace::exporter::RunningSpanStoreImpl;
-  friend class ::opencensus::trace::exporter::LocalSpanStoreImpl;
   friend class ::opencensus::trace::exporter::SpanExporterImpl;
   friend class ::opencensus::trace::SpanTestPeer;
+  friend void IntrusiveRef(SpanImpl* span);
+  friend void IntrusiveUnref(SpanImpl* span);
+
+  // The arena may come from a recycled SpanImpl.
+  SpanImpl(const SpanContext& context, const TraceParams& trace_params,
+           absl::string_view name, const SpanId& parent_span_id,
+           bool remote_parent, common::Arena arena);
+  ~SpanImpl() = default;
+
+  EndedSpan EndedSpanLocked() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
   // Makes a deep copy of span contents and returns copied data in SpanData.
   exporter::SpanData ToSpanData() const ABSL_LOCKS_EXCLUDED(mu_);
 
+  // Like ToSpanData(), but if the caller holds the only reference to this
+  // ended span, moves its contents out instead of copying them. The span must
+  // not be read again afterwards. Used by the exporter.
+  exporter::SpanData TakeSpanData() ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns what End() reported about this ended span. Used by the exporter,
+  // before TakeSpanData().
+  EndedSpan GetEndedSpan() const ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Appends the contents of this ended span to a batch being built. Used by
+  // the exporter, before TakeSpanData().
+  void AppendTo(exporter::SpanBatch* batch) const ABSL_LOCKS_EXCLUDED(mu_);
+
+  struct AnnotationRecord {
+    absl::string_view description;
+    absl::Span<const ArenaAttribute> attributes;
+  };
+
+  struct LinkRecord {
+    SpanContext context;
+    exporter::Link::Type type;
+    absl::Span<const ArenaAttribute> attributes;
+  };
+
+  // Copies everything that is still referenced into a new Arena once the
+  // current one holds more than twice that, so that overwritten attributes and
+  // evicted events do not grow the span without bound.
+  void MaybeCompactArena() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Builds SpanData from the given name, status and message events, and
+  // copies of the other contents.
+  exporter::SpanData MakeSpanData(
+      std::string name, exporter::Status status,
+      std::vector<exporter::SpanData::TimeEvent<exporter::MessageEvent>>
+          message_events) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // The number of SpanImplPtrs pointing to this span.
+  std::atomic<int32_t> ref_count_;
   mutable absl::Mutex mu_;
-  // The start time of the span.
-  const absl::Time start_time_;
-  // The end time of the span. Set when End() is called.
-  absl::Time end_time_ ABSL_GUARDED_BY(mu_);
+  // Holds the contents of attributes_, annotations_ and links_.
+  common::Arena arena_ ABSL_GUARDED_BY(mu_);
+  // arena_.bytes_allocated() at which MaybeCompactArena() compacts.
+  size_t compact_threshold_ ABSL_GUARDED_BY(mu_);
+  // The start time of the span, in common::Clock ticks.
+  const int64_t start_time_;
+  // The end time of the span, in common::Clock ticks. Set when End() is
+  // called.
+  int64_t end_time_ ABSL_GUARDED_BY(mu_);
   // The status of the span. Only set if start_options_.record_events is true.
   exporter::Status status_ ABSL_GUARDED_BY(mu_);
   // The displayed name of the span.
@@ -127,13 +212,13 @@ class SpanImpl final {
   // TraceId, SpanId, and TraceOptions for the current span.
   const SpanContext context_;
   // Queue of recorded annotations.
-  TraceEvents<EventWithTime<exporter::Annotation>> annotations_
+  TraceEvents<EventWithTime<AnnotationRecord>> annotations_
       ABSL_GUARDED_BY(mu_);
   // Queue of recorded network events.
   TraceEvents<EventWithTime<exporter::MessageEvent>> message_events_
       ABSL_GUARDED_BY(mu_);
   // Queue of recorded links to parent and child spans.
-  TraceEvents<exporter::Link> links_ ABSL_GUARDED_BY(mu_);
+  TraceEvents<LinkRecord> links_ ABSL_GUARDED_BY(mu_);
   // Set of recorded attributes.
   AttributeList attributes_ ABSL_GUARDED_BY(mu_);
   // Marks if the span has ended.
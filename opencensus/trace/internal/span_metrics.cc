@@ -0,0 +1,175 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/span_metrics.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "opencensus/stats/stats.h"
+#include "opencensus/tags/tag_key.h"
+#include "opencensus/tags/tag_map.h"
+#include "opencensus/trace/internal/span_counts.h"
+#include "opencensus/trace/internal/span_exporter_impl.h"
+#include "opencensus/trace/status_code.h"
+
+namespace opencensus {
+namespace trace {
+
+namespace {
+
+constexpr char kSpanCountName[] = "opencensus.io/trace/span_count";
+constexpr char kSpanErrorsName[] = "opencensus.io/trace/span_errors";
+constexpr char kSpanErrorCountViewName[] =
+    "opencensus.io/trace/span_error_count";
+constexpr char kSpanLatencyViewName[] = "opencensus.io/trace/span_latency";
+
+// The values of the span_latency tag, one per SpanCounts latency bucket.
+constexpr const char* kLatencyBucketNames[] = {
+    "[0, 10us)",     "[10us, 100us)", "[100us, 1ms)",
+    "[1ms, 10ms)",   "[10ms, 100ms)", "[100ms, 1s)",
+    "[1s, 10s)",     "[10s, 100s)",   "[100s, inf)"};
+static_assert(sizeof(kLatencyBucketNames) / sizeof(kLatencyBucketNames[0]) ==
+                  SpanCounts::kNumLatencyBuckets,
+              "A span_latency value is needed for each latency bucket");
+
+stats::MeasureInt64 SpanCountMeasure() {
+  static const stats::MeasureInt64 measure = stats::MeasureInt64::Register(
+      kSpanCountName, "The number of ended spans.", "1");
+  return measure;
+}
+
+stats::MeasureInt64 SpanErrorsMeasure() {
+  static const stats::MeasureInt64 measure = stats::MeasureInt64::Register(
+      kSpanErrorsName, "The number of ended spans whose status is not OK.",
+      "1");
+  return measure;
+}
+
+tags::TagKey SpanNameKey() {
+  static const tags::TagKey key = tags::TagKey::Register("span_name");
+  return key;
+}
+
+tags::TagKey SpanStatusKey() {
+  static const tags::TagKey key = tags::TagKey::Register("span_status");
+  return key;
+}
+
+tags::TagKey SpanLatencyKey() {
+  static const tags::TagKey key = tags::TagKey::Register("span_latency");
+  return key;
+}
+
+// Records the spans of one name and status counted since the previous flush.
+// Called by the span exporter's worker.
+void RecordCounts(absl::string_view name, StatusCode status_code,
+                  absl::Span<const uint64_t> latency_counts) {
+  const absl::string_view status = StatusCodeToString(status_code);
+  int64_t total = 0;
+  for (size_t bucket = 0; bucket < latency_counts.size(); ++bucket) {
+    if (latency_counts[bucket] == 0) continue;
+    const int64_t count = static_cast<int64_t>(latency_counts[bucket]);
+    total += count;
+    stats::Record(
+        {{SpanCountMeasure(), count}},
+        tags::TagMap({{SpanNameKey(), name},
+                      {SpanStatusKey(), status},
+                      {SpanLatencyKey(), kLatencyBucketNames[bucket]}}));
+  }
+  if (status_code != StatusCode::OK) {
+    stats::Record({{SpanErrorsMeasure(), total}},
+                  tags::TagMap({{SpanNameKey(), name}}));
+  }
+}
+
+}  // namespace
+
+// static
+void SpanMetrics::Enable() {
+  static const bool installed = [] {
+    // Register the measures before any span is recorded.
+    SpanCountMeasure();
+    SpanErrorsMeasure();
+    exporter::SpanExporterImpl::Get()->SetExportListener(
+        [] { SpanCounts::Get()->Flush(&RecordCounts); });
+    return true;
+  }();
+  (void)installed;
+  SpanCounts::Get()->Enable();
+}
+
+// static
+void SpanMetrics::Disable() { SpanCounts::Get()->Disable(); }
+
+// static
+void SpanMetrics::RegisterViewsForExport() {
+  Enable();
+  SpanCountView().RegisterForExport();
+  SpanErrorCountView().RegisterForExport();
+  SpanLatencyView().RegisterForExport();
+}
+
+// static
+const stats::ViewDescriptor& SpanMetrics::SpanCountView() {
+  SpanCountMeasure();
+  static const stats::ViewDescriptor* const descriptor =
+      new stats::ViewDescriptor(
+          stats::ViewDescriptor()
+              .set_name(kSpanCountName)
+              .set_measure(kSpanCountName)
+              .set_aggregation(stats::Aggregation::Sum())
+              .add_column(SpanNameKey())
+              .add_column(SpanStatusKey())
+              .set_description("The number of ended spans, by name and "
+                               "status."));
+  return *descriptor;
+}
+
+// static
+const stats::ViewDescriptor& SpanMetrics::SpanErrorCountView() {
+  SpanErrorsMeasure();
+  static const stats::ViewDescriptor* const descriptor =
+      new stats::ViewDescriptor(
+          stats::ViewDescriptor()
+              .set_name(kSpanErrorCountViewName)
+              .set_measure(kSpanErrorsName)
+              .set_aggregation(stats::Aggregation::Sum())
+              .add_column(SpanNameKey())
+              .set_description("The number of ended spans whose status is "
+                               "not OK, by name."));
+  return *descriptor;
+}
+
+// static
+const stats::ViewDescriptor& SpanMetrics::SpanLatencyView() {
+  SpanCountMeasure();
+  static const stats::ViewDescriptor* const descriptor =
+      new stats::ViewDescriptor(
+          stats::ViewDescriptor()
+              .set_name(kSpanLatencyViewName)
+              .set_measure(kSpanCountName)
+              .set_aggregation(stats::Aggregation::Sum())
+              .add_column(SpanNameKey())
+              .add_column(SpanStatusKey())
+              .add_column(SpanLatencyKey())
+              .set_description("The number of ended spans, by name, status "
+                               "and latency bucket."));
+  return *descriptor;
+}
+
+}  // namespace trace
+}  // namespace opencensus
@@ -0,0 +1,57 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark/benchmark.h"
+#include "opencensus/stats/stats.h"
+#include "opencensus/trace/sampler.h"
+#include "opencensus/trace/span.h"
+#include "opencensus/trace/span_metrics.h"
+
+namespace {
+
+void BM_StartEndUnsampledChildSpanWithoutMetrics(benchmark::State& state) {
+  static ::opencensus::trace::NeverSampler sampler;
+  auto parent = ::opencensus::trace::Span::StartSpan(
+      "Parent", /*parent=*/nullptr, {&sampler});
+  for (auto _ : state) {
+    auto span = ::opencensus::trace::Span::StartSpan("SpanName", &parent);
+    span.End();
+  }
+  parent.End();
+}
+BENCHMARK(BM_StartEndUnsampledChildSpanWithoutMetrics)->ThreadRange(1, 16);
+
+// Enabling the span metrics and registering their views cannot be undone. Keep
+// this benchmark last.
+void BM_StartEndUnsampledChildSpanWithMetrics(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    static const bool registered = [] {
+      ::opencensus::trace::SpanMetrics::RegisterViewsForExport();
+      return true;
+    }();
+    (void)registered;
+  }
+  static ::opencensus::trace::NeverSampler sampler;
+  auto parent = ::opencensus::trace::Span::StartSpan(
+      "Parent", /*parent=*/nullptr, {&sampler});
+  for (auto _ : state) {
+    auto span = ::opencensus::trace::Span::StartSpan("SpanName", &parent);
+    span.End();
+  }
+  parent.End();
+}
+BENCHMARK(BM_StartEndUnsampledChildSpanWithMetrics)->ThreadRange(1, 16);
+
+}  // namespace
+BENCHMARK_MAIN();
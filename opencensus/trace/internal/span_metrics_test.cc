@@ -0,0 +1,166 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/span_metrics.h"
+
+#include <cstdint>
+
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "opencensus/stats/stats.h"
+#include "opencensus/stats/testing/test_utils.h"
+#include "opencensus/trace/exporter/span_exporter.h"
+#include "opencensus/trace/sampler.h"
+#include "opencensus/trace/span.h"
+#include "opencensus/trace/status_code.h"
+#include "opencensus/trace/with_span.h"
+
+namespace opencensus {
+namespace trace {
+namespace exporter {
+
+class SpanExporterTestPeer {
+ public:
+  static constexpr auto& ExportForTesting = SpanExporter::ExportForTesting;
+};
+
+}  // namespace exporter
+
+namespace {
+
+// Records the spans counted so far as stats, as the exporter's worker does
+// after each export.
+void Flush() {
+  exporter::SpanExporterTestPeer::ExportForTesting();
+  stats::testing::TestUtils::Flush();
+}
+
+class SpanMetricsTest : public ::testing::Test {
+ protected:
+  void SetUp() override { SpanMetrics::Enable(); }
+  void TearDown() override { SpanMetrics::Disable(); }
+
+  static AlwaysSampler always_sampler_;
+  static NeverSampler never_sampler_;
+};
+
+AlwaysSampler SpanMetricsTest::always_sampler_;
+NeverSampler SpanMetricsTest::never_sampler_;
+
+TEST_F(SpanMetricsTest, RecordsSampledAndUnsampledSpans) {
+  stats::View count(SpanMetrics::SpanCountView());
+  stats::View errors(SpanMetrics::SpanErrorCountView());
+  stats::View latency(SpanMetrics::SpanLatencyView());
+  ASSERT_TRUE(count.IsValid());
+  ASSERT_TRUE(errors.IsValid());
+  ASSERT_TRUE(latency.IsValid());
+
+  Span::StartSpan("Sampled", nullptr, {&always_sampler_}).End();
+  auto root = Span::StartSpan("Unsampled", nullptr, {&never_sampler_});
+  EXPECT_FALSE(root.IsSampled());
+  EXPECT_FALSE(root.IsRecording());
+  // Children of unsampled spans take the fast path, and are counted too.
+  for (int i = 0; i < 3; ++i) {
+    Span::StartSpan("Child", &root).End();
+  }
+  auto failed = Span::StartSpan("Child", &root);
+  failed.SetStatus(StatusCode::UNAVAILABLE, "unavailable");
+  failed.End();
+  root.SetName("Renamed");
+  root.End();
+  Flush();
+
+  const auto count_data = count.GetData();
+  ASSERT_EQ(stats::ViewData::Type::kInt64, count_data.type());
+  EXPECT_EQ(1, count_data.int_data().at({"Sampled", "OK"}));
+  EXPECT_EQ(3, count_data.int_data().at({"Child", "OK"}));
+  EXPECT_EQ(1, count_data.int_data().at({"Child", "UNAVAILABLE"}));
+  EXPECT_EQ(1, count_data.int_data().at({"Renamed", "OK"}));
+  EXPECT_EQ(0, count_data.int_data().count({"Unsampled", "OK"}));
+
+  const auto error_data = errors.GetData();
+  ASSERT_EQ(stats::ViewData::Type::kInt64, error_data.type());
+  EXPECT_EQ(1, error_data.int_data().at({"Child"}));
+  EXPECT_EQ(0, error_data.int_data().count({"Sampled"}));
+
+  const auto latency_data = latency.GetData();
+  ASSERT_EQ(stats::ViewData::Type::kInt64, latency_data.type());
+  int64_t child_count = 0;
+  for (const auto& row : latency_data.int_data()) {
+    if (row.first[0] == "Child" && row.first[1] == "OK") {
+      child_count += row.second;
+    }
+  }
+  EXPECT_EQ(3, child_count);
+}
+
+TEST_F(SpanMetricsTest, CopiesOfUnsampledSpanAreCountedOnce) {
+  stats::View count(SpanMetrics::SpanCountView());
+  stats::View errors(SpanMetrics::SpanErrorCountView());
+  ASSERT_TRUE(count.IsValid());
+  ASSERT_TRUE(errors.IsValid());
+  auto span = Span::StartSpan("Shared", nullptr, {&never_sampler_});
+  {
+    // The copy in the Context ends the span, with the status set on span.
+    WithSpan ws(span, /*cond=*/true, /*end_span=*/true);
+    span.SetStatus(StatusCode::INTERNAL, "internal");
+  }
+  span.End();
+  Flush();
+  EXPECT_EQ(1, count.GetData().int_data().at({"Shared", "INTERNAL"}));
+  EXPECT_EQ(0, count.GetData().int_data().count({"Shared", "OK"}));
+  EXPECT_EQ(1, errors.GetData().int_data().at({"Shared"}));
+}
+
+TEST_F(SpanMetricsTest, EndingTwiceCountsOnce) {
+  stats::View count(SpanMetrics::SpanCountView());
+  ASSERT_TRUE(count.IsValid());
+  auto unsampled = Span::StartSpan("Twice", nullptr, {&never_sampler_});
+  unsampled.End();
+  unsampled.End();
+  Flush();
+  EXPECT_EQ(1, count.GetData().int_data().at({"Twice", "OK"}));
+}
+
+TEST_F(SpanMetricsTest, CountsLatencyBuckets) {
+  stats::View latency(SpanMetrics::SpanLatencyView());
+  ASSERT_TRUE(latency.IsValid());
+  auto span = Span::StartSpan("Slow", nullptr, {&never_sampler_});
+  absl::SleepFor(absl::Milliseconds(2));
+  span.End();
+  Flush();
+  // Under load the span may take longer than 10ms, but never less than 1ms.
+  const auto data = latency.GetData().int_data();
+  int64_t slow_count = 0;
+  for (const char* bucket : {"[1ms, 10ms)", "[10ms, 100ms)", "[100ms, 1s)"}) {
+    const auto it = data.find({"Slow", "OK", bucket});
+    if (it != data.end()) slow_count += it->second;
+  }
+  EXPECT_EQ(1, slow_count);
+}
+
+TEST_F(SpanMetricsTest, DisableStopsRecording) {
+  stats::View count(SpanMetrics::SpanCountView());
+  ASSERT_TRUE(count.IsValid());
+  SpanMetrics::Disable();
+  Span::StartSpan("Disabled", nullptr, {&always_sampler_}).End();
+  Span::StartSpan("Disabled", nullptr, {&never_sampler_}).End();
+  Flush();
+  EXPECT_EQ(0, count.GetData().int_data().count({"Disabled", "OK"}));
+}
+
+}  // namespace
+}  // namespace trace
+}  // namespace opencensus
@@ -15,6 +15,10 @@
 #include "opencensus/trace/span.h"
 
 #include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
@@ -69,6 +73,32 @@ TEST(SpanTest, ChildInheritsSamplingFromParent) {
             SpanTestPeer::GetParentSpanId(&child_span));
 }
 
+TEST(SpanTest, ChildInheritsNotSampledFromLocalParent) {
+  NeverSampler never;
+  auto root_span = Span::StartSpan("MyRootSpan", /*parent=*/nullptr, {&never});
+  TraceConfig::SetCurrentTraceParams(
+      TraceParams{32, 32, 128, 128, ProbabilitySampler(1.0)});
+  auto child_span1 = Span::StartSpan("MyChildSpan", &root_span);
+  auto child_span2 = Span::StartSpan("MyChildSpan", &root_span);
+  EXPECT_FALSE(child_span1.IsSampled());
+  EXPECT_FALSE(child_span1.IsRecording());
+  EXPECT_EQ(root_span.context().trace_id(), child_span1.context().trace_id());
+  EXPECT_TRUE(child_span1.context().span_id().IsValid());
+  EXPECT_FALSE(child_span1.context().span_id() ==
+               root_span.context().span_id());
+  EXPECT_FALSE(child_span1.context().span_id() ==
+               child_span2.context().span_id());
+
+  AlwaysSampler always;
+  auto child_span3 = Span::StartSpan("MyChildSpan", &root_span, {&always});
+  EXPECT_TRUE(child_span3.IsSampled()) << "An explicit Sampler is consulted.";
+
+  child_span1.End();
+  child_span2.End();
+  child_span3.End();
+  root_span.End();
+}
+
 TEST(SpanTest, AddAttributesLastValueWins) {
   AlwaysSampler sampler;
   auto span = Span::StartSpan("SpanName", /*parent=*/nullptr, {&sampler});
@@ -129,6 +159,47 @@ TEST(SpanTest, AddAnnotationLastAttributeWins) {
                                  .string_value());
 }
 
+TEST(SpanTest, ManyUpdatesKeepLatestContents) {
+  AlwaysSampler sampler;
+  auto span = Span::StartSpan("SpanName", /*parent=*/nullptr, {&sampler});
+  // Enough overwritten attributes and evicted annotations to compact the
+  // span's storage several times.
+  for (int i = 0; i < 1000; ++i) {
+    const std::string value = absl::StrCat("a long attribute value ", i);
+    span.AddAttributes({{"key", value}, {absl::StrCat("key", i % 40), i}});
+    span.AddAnnotation(absl::StrCat("annotation ", i), {{"index", value}});
+  }
+  span.End();
+  const auto data = SpanTestPeer::ToSpanData(&span);
+  EXPECT_EQ("a long attribute value 999",
+            data.attributes().at("key").string_value());
+  EXPECT_EQ(999, data.attributes().at("key39").int_value());
+  ASSERT_FALSE(data.annotations().events().empty());
+  const auto& last = data.annotations().events().back().event();
+  EXPECT_EQ("annotation 999", last.description());
+  EXPECT_EQ("a long attribute value 999",
+            last.attributes().at("index").string_value());
+}
+
+TEST(SpanTest, RecycledSpansStartEmpty) {
+  AlwaysSampler sampler;
+  for (int round = 0; round < 3; ++round) {
+    std::vector<Span> spans;
+    for (int i = 0; i < 300; ++i) {
+      auto span = Span::StartSpan("SpanName", /*parent=*/nullptr, {&sampler});
+      const auto data = SpanTestPeer::ToSpanData(&span);
+      EXPECT_TRUE(data.attributes().empty());
+      EXPECT_TRUE(data.annotations().events().empty());
+      span.AddAttributes({{"key", absl::StrCat("value ", i)}});
+      span.AddAnnotation("annotation", {{"round", round}});
+      span.End();
+      spans.push_back(std::move(span));
+    }
+    // Drop the spans on another thread, which hands them back in batches.
+    std::thread([&spans] { spans.clear(); }).join();
+  }
+}
+
 TEST(SpanTest, ParentLinksFromOptions) {
   AlwaysSampler sampler;
   auto parent0 = Span::StartSpan("Parent0", /*parent=*/nullptr, {&sampler});
@@ -316,8 +387,22 @@ TEST(SpanTest, ForceSamplingOffViaTraceConfig) {
   for (int i = 0; i < 1000; ++i) {
     auto span = Span::StartSpan("SpanName");
     EXPECT_FALSE(span.IsSampled());
+    EXPECT_FALSE(span.IsRecording());
+    EXPECT_TRUE(span.context().IsValid());
     span.End();
   }
+
+  // Spans with a remote parent that isn't sampled still get their own SpanId.
+  constexpr uint8_t trace_id[] = {1, 2,  3,  4,  5,  6,  7,  8,
+                                  9, 10, 11, 12, 13, 14, 15, 16};
+  constexpr uint8_t span_id[] = {1, 0, 0, 0, 0, 0, 0, 11};
+  const SpanContext parent_ctx{TraceId(trace_id), SpanId(span_id)};
+  auto span = Span::StartSpanWithRemoteParent("SpanName", parent_ctx);
+  EXPECT_FALSE(span.IsSampled());
+  EXPECT_EQ(parent_ctx.trace_id(), span.context().trace_id());
+  EXPECT_TRUE(span.context().span_id().IsValid());
+  EXPECT_FALSE(span.context().span_id() == parent_ctx.span_id());
+  span.End();
 }
 
 TEST(SpanTest, CheckSpanData) {
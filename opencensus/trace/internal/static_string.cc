@@ -0,0 +1,92 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/static_string.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+
+namespace opencensus {
+namespace trace {
+
+namespace {
+// The size of the table that interned strings are copied into. Strings
+// interned once it is full are copied to the heap instead, and are no longer
+// recognized by IsInterned().
+constexpr size_t kTableBytes = 64 * 1024;
+
+// Interned strings are packed into a single static buffer, so that
+// IsInterned() only needs to compare addresses.
+char interned_strings[kTableBytes];
+
+class StaticStringTable {
+ public:
+  static StaticStringTable* Get() {
+    static StaticStringTable* global_static_string_table =
+        new StaticStringTable;
+    return global_static_string_table;
+  }
+
+  absl::string_view Intern(absl::string_view s) ABSL_LOCKS_EXCLUDED(mu_);
+
+ private:
+  absl::Mutex mu_;
+  // The number of bytes of interned_strings in use.
+  size_t used_ ABSL_GUARDED_BY(mu_) = 0;
+  // A map from contents to the interned copy.
+  std::unordered_map<std::string, absl::string_view> interned_
+      ABSL_GUARDED_BY(mu_);
+};
+
+absl::string_view StaticStringTable::Intern(absl::string_view s) {
+  if (s.empty()) return absl::string_view();
+  absl::MutexLock l(&mu_);
+  std::string key(s);
+  const auto it = interned_.find(key);
+  if (it != interned_.end()) {
+    return it->second;
+  }
+  absl::string_view copy;
+  if (s.size() <= kTableBytes - used_) {
+    char* data = interned_strings + used_;
+    memcpy(data, s.data(), s.size());
+    used_ += s.size();
+    copy = absl::string_view(data, s.size());
+  } else {
+    copy = *new std::string(s);
+  }
+  interned_.emplace(std::move(key), copy);
+  return copy;
+}
+}  // namespace
+
+StaticString StaticString::Intern(absl::string_view s) {
+  return StaticString(FromView(), StaticStringTable::Get()->Intern(s));
+}
+
+bool StaticString::IsInterned(absl::string_view s) {
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(interned_strings);
+  const uintptr_t data = reinterpret_cast<uintptr_t>(s.data());
+  return data >= begin && data + s.size() <= begin + kTableBytes;
+}
+
+}  // namespace trace
+}  // namespace opencensus
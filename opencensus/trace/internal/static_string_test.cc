@@ -0,0 +1,66 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/static_string.h"
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "gtest/gtest.h"
+#include "opencensus/trace/attribute_value_ref.h"
+
+namespace opencensus {
+namespace trace {
+namespace {
+
+TEST(StaticStringTest, Literal) {
+  constexpr StaticString s = StaticString::Literal("literal");
+  EXPECT_EQ("literal", s.view());
+  EXPECT_FALSE(StaticString::IsInterned(s));
+}
+
+TEST(StaticStringTest, LiteralEndsAtFirstNul) {
+  static const char kBuffer[32] = "short";
+  EXPECT_EQ("short", StaticString::Literal(kBuffer).view());
+  EXPECT_EQ("a", StaticString::Literal("a\0b").view());
+  EXPECT_EQ("", StaticString::Literal("").view());
+}
+
+TEST(StaticStringTest, InternReturnsSameCopy) {
+  std::string contents = "interned key";
+  const StaticString a = StaticString::Intern(contents);
+  contents = "something else";
+  const StaticString b = StaticString::Intern("interned key");
+  EXPECT_EQ("interned key", a.view());
+  EXPECT_EQ(a.view().data(), b.view().data());
+  EXPECT_TRUE(StaticString::IsInterned(a));
+  EXPECT_TRUE(StaticString::IsInterned(a.view().substr(3, 4)));
+  EXPECT_FALSE(StaticString::IsInterned(contents));
+}
+
+TEST(StaticStringTest, AttributeValueRef) {
+  EXPECT_TRUE(
+      AttributeValueRef(StaticString::Literal("value")).has_static_storage());
+  EXPECT_TRUE(
+      AttributeValueRef(StaticString::Intern("value").view())
+          .has_static_storage());
+  EXPECT_FALSE(AttributeValueRef("value").has_static_storage());
+  EXPECT_FALSE(AttributeValueRef(1).has_static_storage());
+  EXPECT_EQ(AttributeValueRef("value"),
+            AttributeValueRef(StaticString::Literal("value")));
+}
+
+}  // namespace
+}  // namespace trace
+}  // namespace opencensus
@@ -0,0 +1,164 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/internal/tail_sampling_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "opencensus/trace/internal/span_exporter_impl.h"
+#include "opencensus/trace/internal/span_impl.h"
+#include "opencensus/trace/sampler.h"
+#include "opencensus/trace/span_context.h"
+#include "opencensus/trace/status_code.h"
+#include "opencensus/trace/tail_sampling_policy.h"
+#include "opencensus/trace/trace_id.h"
+
+namespace opencensus {
+namespace trace {
+namespace exporter {
+
+constexpr size_t TailSamplingBuffer::kNumShards;
+
+size_t TailSamplingBuffer::TraceIdHash::operator()(
+    const TraceId& trace_id) const {
+  // TraceIds are random, so any 8 bytes make a good hash.
+  uint8_t buf[TraceId::kSize];
+  trace_id.CopyTo(buf);
+  uint64_t bits = 0;
+  for (int i = 0; i < 8; ++i) {
+    bits |= static_cast<uint64_t>(buf[i]) << (i * 8);
+  }
+  return static_cast<size_t>(bits);
+}
+
+TailSamplingBuffer* TailSamplingBuffer::Get() {
+  static TailSamplingBuffer* global_tail_sampling_buffer =
+      new TailSamplingBuffer;
+  return global_tail_sampling_buffer;
+}
+
+void TailSamplingBuffer::SetPolicy(const TailSamplingPolicy* policy) {
+  absl::MutexLock l(&mu_);
+  if (policy == nullptr) {
+    policy_.store(nullptr, std::memory_order_release);
+    Clear();
+    return;
+  }
+  policies_.emplace_back(new TailSamplingPolicy(*policy));
+  policy_.store(policies_.back().get(), std::memory_order_release);
+}
+
+TailSamplingBuffer::Shard& TailSamplingBuffer::GetShard(
+    const TraceId& trace_id) {
+  // Use other bits than the unordered_map within the shard.
+  return shards_[(TraceIdHash()(trace_id) >> 56) % kNumShards];
+}
+
+size_t TailSamplingBuffer::Shard::EvictOldest() {
+  while (!order.empty()) {
+    const auto oldest = order.front();
+    order.pop_front();
+    const auto it = traces.find(oldest.first);
+    if (it != traces.end() && it->second.sequence == oldest.second) {
+      const size_t num_spans = it->second.spans.size();
+      traces.erase(it);
+      return num_spans;
+    }
+  }
+  return 0;
+}
+
+bool TailSamplingBuffer::ShouldExport(const TailSamplingPolicy& policy,
+                                      const SpanImpl& root, bool has_error) {
+  return (policy.errors && has_error) ||
+         root.latency() >= policy.min_latency ||
+         ProbabilitySampler(policy.probability)
+             .ShouldSample(nullptr, /*has_remote_parent=*/false,
+                           root.context().trace_id(), root.context().span_id(),
+                           /*name=*/"", /*parent_links=*/{});
+}
+
+void TailSamplingBuffer::AddSpan(const SpanImplPtr& span) {
+  const TailSamplingPolicy* policy = policy_.load(std::memory_order_acquire);
+  if (policy == nullptr) {
+    return;  // Disabled since the span started.
+  }
+  const TraceId trace_id = span->context().trace_id();
+  const bool is_root =
+      !span->parent_span_id().IsValid() || span->remote_parent();
+  const bool is_error = span->status_code() != StatusCode::OK;
+
+  // Spans are exported, and dropped spans released, outside the lock.
+  std::vector<SpanImplPtr> exported;
+  std::vector<SpanImplPtr> dropped;
+  Shard& shard = GetShard(trace_id);
+  {
+    absl::MutexLock l(&shard.mu);
+    auto it = shard.traces.find(trace_id);
+    if (it == shard.traces.end()) {
+      // A root that ends first still leaves its decision behind, with no
+      // spans, for children that were started earlier but end later.
+      const size_t max_traces =
+          std::max<size_t>(1, policy->max_traces / kNumShards);
+      while (shard.traces.size() >= max_traces) {
+        dropped_spans_.fetch_add(shard.EvictOldest(),
+                                 std::memory_order_relaxed);
+      }
+      it = shard.traces.emplace(trace_id, Trace()).first;
+      it->second.sequence = shard.next_sequence++;
+      shard.order.emplace_back(trace_id, it->second.sequence);
+    }
+    Trace& trace = it->second;
+    trace.has_error = trace.has_error || is_error;
+    if (is_root && trace.decision != Decision::kExport) {
+      const bool keep = ShouldExport(*policy, *span, trace.has_error);
+      trace.decision = keep ? Decision::kExport : Decision::kDrop;
+      (keep ? exported : dropped).swap(trace.spans);
+    }
+    switch (trace.decision) {
+      case Decision::kUndecided:
+        if (trace.spans.size() < policy->max_spans_per_trace) {
+          trace.spans.push_back(span);
+        } else {
+          dropped_spans_.fetch_add(1, std::memory_order_relaxed);
+        }
+        break;
+      case Decision::kExport:
+        exported.push_back(span);
+        break;
+      case Decision::kDrop:
+        break;
+    }
+  }
+  for (const auto& exported_span : exported) {
+    SpanExporterImpl::Get()->AddSpan(exported_span);
+  }
+}
+
+void TailSamplingBuffer::Clear() {
+  for (auto& shard : shards_) {
+    absl::MutexLock l(&shard.mu);
+    shard.traces.clear();
+    shard.order.clear();
+  }
+}
+
+}  // namespace exporter
+}  // namespace trace
+}  // namespace opencensus
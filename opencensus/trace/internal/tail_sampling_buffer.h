@@ -0,0 +1,131 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_TRACE_INTERNAL_TAIL_SAMPLING_BUFFER_H_
+#define OPENCENSUS_TRACE_INTERNAL_TAIL_SAMPLING_BUFFER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "absl/base/optimization.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "opencensus/trace/span_impl_ptr.h"
+#include "opencensus/trace/tail_sampling_policy.h"
+#include "opencensus/trace/trace_id.h"
+
+namespace opencensus {
+namespace trace {
+
+class SpanImpl;
+
+namespace exporter {
+
+// TailSamplingBuffer holds ended spans that were recorded but not sampled,
+// grouped by TraceId, until the trace is either exported or dropped according
+// to the TailSamplingPolicy. See tail_sampling_policy.h.
+//
+// This class is thread-safe and a singleton.
+class TailSamplingBuffer final {
+ public:
+  // Returns the global instance of TailSamplingBuffer.
+  static TailSamplingBuffer* Get();
+
+  // Enables tail sampling with the policy, or disables it if policy is
+  // nullptr. Disabling drops the buffered spans.
+  void SetPolicy(const TailSamplingPolicy* policy) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns true if spans that are not sampled should still be recorded, and
+  // passed to AddSpan() when they end.
+  bool enabled() const {
+    return policy_.load(std::memory_order_relaxed) != nullptr;
+  }
+
+  // Buffers, exports or drops an ended span that was not sampled.
+  void AddSpan(const SpanImplPtr& span) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the number of spans dropped because the buffer was full, either
+  // when they ended or when their undecided trace was evicted.
+  uint64_t dropped_spans() const {
+    return dropped_spans_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Traces are spread over shards by TraceId so that spans of different
+  // traces rarely contend on the same mutex.
+  static constexpr size_t kNumShards = 16;
+
+  struct TraceIdHash {
+    size_t operator()(const TraceId& trace_id) const;
+  };
+
+  enum class Decision : uint8_t { kUndecided, kExport, kDrop };
+
+  struct Trace {
+    std::vector<SpanImplPtr> spans;
+    // Identifies this entry in Shard::order.
+    uint64_t sequence;
+    bool has_error = false;
+    Decision decision = Decision::kUndecided;
+  };
+
+  struct Shard {
+    // Removes the oldest trace. Returns the number of spans it buffered.
+    size_t EvictOldest() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu);
+
+    absl::Mutex mu;
+    std::unordered_map<TraceId, Trace, TraceIdHash> traces ABSL_GUARDED_BY(mu);
+    // TraceIds with their sequence number, oldest first. Entries whose trace
+    // has been removed or re-added are skipped.
+    std::deque<std::pair<TraceId, uint64_t>> order ABSL_GUARDED_BY(mu);
+    uint64_t next_sequence ABSL_GUARDED_BY(mu) = 0;
+    // Keeps neighbouring shards' mutexes off this cache line.
+    char pad[ABSL_CACHELINE_SIZE];
+  };
+
+  TailSamplingBuffer() : policy_(nullptr) {}
+
+  Shard& GetShard(const TraceId& trace_id);
+
+  // Returns true if the trace should be exported now that its local root has
+  // ended.
+  static bool ShouldExport(const TailSamplingPolicy& policy,
+                           const SpanImpl& root, bool has_error);
+
+  // Clears all buffered traces.
+  void Clear();
+
+  // The current policy, or nullptr if tail sampling is disabled.
+  std::atomic<const TailSamplingPolicy*> policy_;
+  std::atomic<uint64_t> dropped_spans_{0};
+  absl::Mutex mu_;
+  // Owns every policy that has been set, since AddSpan() may still be reading
+  // a replaced one.
+  std::vector<std::unique_ptr<TailSamplingPolicy>> policies_
+      ABSL_GUARDED_BY(mu_);
+  std::array<Shard, kNumShards> shards_;
+};
+
+}  // namespace exporter
+}  // namespace trace
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_TRACE_INTERNAL_TAIL_SAMPLING_BUFFER_H_
@@ -0,0 +1,206 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/internal/tail_sampling_buffer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "gtest/gtest.h"
+#include "opencensus/trace/exporter/span_data.h"
+#include "opencensus/trace/exporter/span_exporter.h"
+#include "opencensus/trace/sampler.h"
+#include "opencensus/trace/span.h"
+#include "opencensus/trace/status_code.h"
+#include "opencensus/trace/tail_sampling_policy.h"
+#include "opencensus/trace/trace_config.h"
+
+namespace opencensus {
+namespace trace {
+
+namespace exporter {
+class SpanExporterTestPeer {
+ public:
+  static constexpr auto& ExportForTesting = SpanExporter::ExportForTesting;
+};
+}  // namespace exporter
+
+namespace {
+
+// Records the names of exported spans.
+class NameRecorder : public exporter::SpanExporter::Handler {
+ public:
+  static std::vector<std::string> TakeNames() {
+    exporter::SpanExporterTestPeer::ExportForTesting();
+    absl::MutexLock l(&mu_);
+    std::vector<std::string> names;
+    names.swap(*names_);
+    return names;
+  }
+
+  void Export(const std::vector<exporter::SpanData>& spans) override {
+    absl::MutexLock l(&mu_);
+    for (const auto& span : spans) {
+      names_->push_back(std::string(span.name()));
+    }
+  }
+
+ private:
+  static absl::Mutex mu_;
+  static std::vector<std::string>* names_ ABSL_GUARDED_BY(mu_);
+};
+
+absl::Mutex NameRecorder::mu_;
+std::vector<std::string>* NameRecorder::names_ = new std::vector<std::string>;
+
+class TailSamplingBufferTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    exporter::SpanExporter::RegisterHandler(absl::make_unique<NameRecorder>());
+  }
+
+  void SetUp() override {
+    TailSamplingPolicy policy;
+    policy.min_latency = absl::Milliseconds(50);
+    TraceConfig::EnableTailSampling(policy);
+    NameRecorder::TakeNames();
+  }
+
+  void TearDown() override { TraceConfig::DisableTailSampling(); }
+
+  static NeverSampler never_sampler_;
+};
+
+NeverSampler TailSamplingBufferTest::never_sampler_;
+
+TEST_F(TailSamplingBufferTest, UnsampledSpansAreRecorded) {
+  auto span = Span::StartSpan("Root", nullptr, {&never_sampler_});
+  EXPECT_FALSE(span.context().trace_options().IsSampled());
+  EXPECT_TRUE(span.IsRecording());
+  span.End();
+}
+
+TEST_F(TailSamplingBufferTest, FastTraceIsDropped) {
+  auto root = Span::StartSpan("Root", nullptr, {&never_sampler_});
+  auto child = Span::StartSpan("Child", &root);
+  child.End();
+  root.End();
+  EXPECT_TRUE(NameRecorder::TakeNames().empty());
+}
+
+TEST_F(TailSamplingBufferTest, SlowTraceIsExported) {
+  auto root = Span::StartSpan("Root", nullptr, {&never_sampler_});
+  auto child = Span::StartSpan("Child", &root);
+  child.End();
+  absl::SleepFor(absl::Milliseconds(60));
+  root.End();
+  // A child that ends after the decision follows it.
+  auto late = Span::StartSpan("Late", &root);
+  late.End();
+  EXPECT_EQ((std::vector<std::string>{"Child", "Root", "Late"}),
+            NameRecorder::TakeNames());
+}
+
+TEST_F(TailSamplingBufferTest, ChildEndingAfterRootFollowsDecision) {
+  auto root = Span::StartSpan("Root", nullptr, {&never_sampler_});
+  auto child = Span::StartSpan("Child", &root);
+  absl::SleepFor(absl::Milliseconds(60));
+  root.End();
+  child.End();
+  EXPECT_EQ((std::vector<std::string>{"Root", "Child"}),
+            NameRecorder::TakeNames());
+}
+
+TEST_F(TailSamplingBufferTest, ChildEndingAfterDroppedRootIsDropped) {
+  auto root = Span::StartSpan("Root", nullptr, {&never_sampler_});
+  auto child = Span::StartSpan("Child", &root);
+  root.End();
+  child.End();
+  EXPECT_TRUE(NameRecorder::TakeNames().empty());
+}
+
+TEST_F(TailSamplingBufferTest, TraceWithErrorIsExported) {
+  auto root = Span::StartSpan("Root", nullptr, {&never_sampler_});
+  auto child = Span::StartSpan("Child", &root);
+  auto grandchild = Span::StartSpan("Grandchild", &child);
+  grandchild.SetStatus(StatusCode::UNAVAILABLE);
+  grandchild.End();
+  child.End();
+  root.End();
+  EXPECT_EQ((std::vector<std::string>{"Grandchild", "Child", "Root"}),
+            NameRecorder::TakeNames());
+}
+
+TEST_F(TailSamplingBufferTest, SpansPerTraceAreBounded) {
+  TailSamplingPolicy policy;
+  policy.probability = 1;
+  policy.max_spans_per_trace = 2;
+  TraceConfig::EnableTailSampling(policy);
+  const uint64_t dropped_before =
+      exporter::TailSamplingBuffer::Get()->dropped_spans();
+
+  auto root = Span::StartSpan("Root", nullptr, {&never_sampler_});
+  for (int i = 0; i < 5; ++i) {
+    Span::StartSpan("Child", &root).End();
+  }
+  root.End();
+  EXPECT_EQ(3, NameRecorder::TakeNames().size());
+  EXPECT_EQ(3,
+            exporter::TailSamplingBuffer::Get()->dropped_spans() -
+                dropped_before);
+}
+
+TEST_F(TailSamplingBufferTest, OldestTraceIsEvicted) {
+  TailSamplingPolicy policy;
+  policy.probability = 1;
+  policy.max_traces = 1;
+  TraceConfig::EnableTailSampling(policy);
+
+  // With a single trace per shard, enough other traces evict the first one
+  // whichever shard it lands in.
+  const uint64_t dropped_before =
+      exporter::TailSamplingBuffer::Get()->dropped_spans();
+  auto first = Span::StartSpan("First", nullptr, {&never_sampler_});
+  Span::StartSpan("FirstChild", &first).End();
+  for (int i = 0; i < 1000; ++i) {
+    auto other = Span::StartSpan("Other", nullptr, {&never_sampler_});
+    Span::StartSpan("OtherChild", &other).End();
+    other.End();
+  }
+  first.End();
+  const auto names = NameRecorder::TakeNames();
+  EXPECT_EQ(names.end(), std::find(names.begin(), names.end(), "FirstChild"));
+  EXPECT_NE(names.end(), std::find(names.begin(), names.end(), "First"));
+  // Only the first trace was evicted before its root ended, with one span.
+  EXPECT_EQ(1,
+            exporter::TailSamplingBuffer::Get()->dropped_spans() -
+                dropped_before);
+}
+
+TEST_F(TailSamplingBufferTest, DisablingStopsRecording) {
+  TraceConfig::DisableTailSampling();
+  auto span = Span::StartSpan("Root", nullptr, {&never_sampler_});
+  EXPECT_FALSE(span.IsRecording());
+  span.End();
+}
+
+}  // namespace
+}  // namespace trace
+}  // namespace opencensus
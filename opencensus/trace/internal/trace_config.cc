@@ -13,7 +13,14 @@
 // limitations under the License.
 
 #include "opencensus/trace/trace_config.h"
+
+#include <memory>
+#include <utility>
+
+#include "opencensus/trace/internal/tail_sampling_buffer.h"
 #include "opencensus/trace/internal/trace_config_impl.h"
+#include "opencensus/trace/sampler.h"
+#include "opencensus/trace/tail_sampling_policy.h"
 #include "opencensus/trace/trace_params.h"
 
 namespace opencensus {
@@ -23,5 +30,17 @@ void TraceConfig::SetCurrentTraceParams(const TraceParams& params) {
   TraceConfigImpl::Get()->SetCurrentTraceParams(params);
 }
 
+void TraceConfig::SetSampler(std::unique_ptr<Sampler> sampler) {
+  TraceConfigImpl::Get()->SetSampler(std::move(sampler));
+}
+
+void TraceConfig::EnableTailSampling(const TailSamplingPolicy& policy) {
+  exporter::TailSamplingBuffer::Get()->SetPolicy(&policy);
+}
+
+void TraceConfig::DisableTailSampling() {
+  exporter::TailSamplingBuffer::Get()->SetPolicy(nullptr);
+}
+
 }  // namespace trace
 }  // namespace opencensus
@@ -15,7 +15,10 @@
 #include "opencensus/trace/internal/trace_config_impl.h"
 
 #include <cstdint>
+#include <memory>
+#include <utility>
 
+#include "absl/synchronization/mutex.h"
 #include "opencensus/trace/sampler.h"
 #include "opencensus/trace/trace_params.h"
 
@@ -42,5 +45,14 @@ TraceConfigImpl* TraceConfigImpl::Get() {
   return global_trace_params;
 }
 
+void TraceConfigImpl::SetSampler(std::unique_ptr<Sampler> sampler) {
+  absl::MutexLock l(&mu_);
+  const Sampler* current = sampler.get();
+  if (sampler != nullptr) {
+    samplers_.push_back(std::move(sampler));
+  }
+  sampler_.store(current, std::memory_order_release);
+}
+
 }  // namespace trace
 }  // namespace opencensus
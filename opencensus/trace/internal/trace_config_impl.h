@@ -15,9 +15,14 @@
 #ifndef OPENCENSUS_TRACE_INTERNAL_TRACE_CONFIG_IMPL_H_
 #define OPENCENSUS_TRACE_INTERNAL_TRACE_CONFIG_IMPL_H_
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
 #include "opencensus/trace/internal/trace_params_impl.h"
+#include "opencensus/trace/sampler.h"
 #include "opencensus/trace/trace_config.h"
 #include "opencensus/trace/trace_params.h"
 
@@ -39,10 +44,30 @@ class TraceConfigImpl {
     return current_trace_params_.Get();
   }
 
+  void SetSampler(std::unique_ptr<Sampler> sampler) ABSL_LOCKS_EXCLUDED(mu_);
+
+  // Returns the Sampler set by SetSampler(), or nullptr if the sampler in
+  // current_trace_params() should be used.
+  const Sampler* sampler() const {
+    return sampler_.load(std::memory_order_acquire);
+  }
+
+  // Returns true if spans started without a Sampler in their StartSpanOptions
+  // are never sampled: no Sampler is set and the sampling probability is 0.
+  bool NeverSamples() const {
+    return sampler() == nullptr &&
+           current_trace_params_.probability_threshold() == 0;
+  }
+
  private:
-  TraceConfigImpl(const TraceParams& params) : current_trace_params_(params) {}
+  TraceConfigImpl(const TraceParams& params)
+      : current_trace_params_(params), sampler_(nullptr) {}
 
   TraceParamsImpl current_trace_params_;
+  std::atomic<const Sampler*> sampler_;
+  absl::Mutex mu_;
+  // Owns every Sampler that has been set, current or not.
+  std::vector<std::unique_ptr<Sampler>> samplers_ ABSL_GUARDED_BY(mu_);
 };
 
 }  // namespace trace
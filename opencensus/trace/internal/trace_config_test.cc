@@ -17,8 +17,10 @@
 #include <atomic>
 #include <thread>
 
+#include "absl/memory/memory.h"
 #include "absl/time/clock.h"
 #include "gtest/gtest.h"
+#include "opencensus/trace/sampler.h"
 #include "opencensus/trace/span.h"
 #include "opencensus/trace/trace_params.h"
 
@@ -62,6 +64,22 @@ TEST(TraceConfigTest, MultiThreaded) {
   }
 }
 
+TEST(TraceConfigTest, SetSampler) {
+  TraceConfig::SetSampler(absl::make_unique<AlwaysSampler>());
+  EXPECT_TRUE(Span::StartSpan("MySpan").IsSampled());
+  NeverSampler never;
+  EXPECT_FALSE(Span::StartSpan("MySpan", nullptr, {&never}).IsSampled())
+      << "The sampler in StartSpanOptions takes precedence.";
+
+  TraceConfig::SetSampler(absl::make_unique<NeverSampler>());
+  EXPECT_FALSE(Span::StartSpan("MySpan").IsSampled());
+
+  TraceConfig::SetSampler(nullptr);
+  TraceConfig::SetCurrentTraceParams(
+      {32, 32, 128, 32, ProbabilitySampler(1.0)});
+  EXPECT_TRUE(Span::StartSpan("MySpan").IsSampled());
+}
+
 }  // namespace
 }  // namespace trace
 }  // namespace opencensus
@@ -14,40 +14,19 @@
 
 #include "opencensus/trace/propagation/trace_context.h"
 
+#include <cstdint>
+#include <string>
+
+#include "opencensus/common/internal/hex.h"
 #include "opencensus/trace/span_context.h"
 #include "opencensus/trace/span_id.h"
 #include "opencensus/trace/trace_id.h"
 #include "opencensus/trace/trace_options.h"
 
-#include "absl/strings/ascii.h"
-#include "absl/strings/escaping.h"
-#include "absl/strings/str_cat.h"
-
 namespace opencensus {
 namespace trace {
 namespace propagation {
 
-namespace {
-
-// Returns true if the string only contains valid lowercase hex digits.
-bool IsLowercaseHexDigits(absl::string_view s) {
-  for (int i = 0; i < s.length(); ++i) {
-    if (!((s[i] >= '0' && s[i] <= '9') || (s[i] >= 'a' && s[i] <= 'f'))) {
-      return false;
-    }
-  }
-  return true;
-}
-
-// Returns true if the converted string was valid hex.
-bool FromHex(absl::string_view hex, std::string* bin) {
-  if (!IsLowercaseHexDigits(hex)) return false;
-  *bin = absl::HexStringToBytes(hex);
-  return true;
-}
-
-}  // namespace
-
 SpanContext FromTraceParentHeader(absl::string_view header) {
   constexpr int kDelimiterLen = 1;
   constexpr char kDelimiter = '-';
@@ -76,20 +55,40 @@ SpanContext FromTraceParentHeader(absl::string_view header) {
       header[kOptionsOfs - kDelimiterLen] != kDelimiter) {
     return invalid;  // Invalid length, version or format.
   }
-  std::string trace_id_bin, span_id_bin, options_bin;
-  if (!FromHex(header.substr(kTraceIdOfs, kTraceIdLenHex), &trace_id_bin) ||
-      !FromHex(header.substr(kSpanIdOfs, kSpanIdLenHex), &span_id_bin) ||
-      !FromHex(header.substr(kOptionsOfs, kTraceOptionsLenHex), &options_bin)) {
+  uint8_t trace_id_bin[kTraceIdLen];
+  uint8_t span_id_bin[kSpanIdLen];
+  uint8_t options_bin[kTraceOptionsLen];
+  if (!common::HexToBytes(header.substr(kTraceIdOfs, kTraceIdLenHex),
+                          trace_id_bin, /*lowercase_only=*/true) ||
+      !common::HexToBytes(header.substr(kSpanIdOfs, kSpanIdLenHex),
+                          span_id_bin, /*lowercase_only=*/true) ||
+      !common::HexToBytes(header.substr(kOptionsOfs, kTraceOptionsLenHex),
+                          options_bin, /*lowercase_only=*/true)) {
     return invalid;  // Invalid hex.
   }
-  return SpanContext(
-      TraceId(reinterpret_cast<const uint8_t*>(trace_id_bin.data())),
-      SpanId(reinterpret_cast<const uint8_t*>(span_id_bin.data())),
-      TraceOptions(reinterpret_cast<const uint8_t*>(options_bin.data())));
+  return SpanContext(TraceId(trace_id_bin), SpanId(span_id_bin),
+                     TraceOptions(options_bin));
 }
 
 std::string ToTraceParentHeader(const SpanContext& ctx) {
-  return absl::StrCat("00-", ctx.ToString());
+  std::string header(kTraceParentHeaderLen, '\0');
+  ToTraceParentHeader(ctx, &header[0]);
+  return header;
+}
+
+void ToTraceParentHeader(const SpanContext& ctx, char* out) {
+  uint8_t buf[TraceId::kSize];
+  out[0] = '0';
+  out[1] = '0';
+  out[2] = '-';
+  ctx.trace_id().CopyTo(buf);
+  common::BytesToHex(buf, TraceId::kSize, out + 3);
+  out[35] = '-';
+  ctx.span_id().CopyTo(buf);
+  common::BytesToHex(buf, SpanId::kSize, out + 36);
+  out[52] = '-';
+  ctx.trace_options().CopyTo(buf);
+  common::BytesToHex(buf, TraceOptions::kSize, out + 53);
 }
 
 }  // namespace propagation
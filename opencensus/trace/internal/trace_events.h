@@ -15,83 +15,161 @@
 #ifndef OPENCENSUS_TRACE_INTERNAL_TRACE_EVENTS_H_
 #define OPENCENSUS_TRACE_INTERNAL_TRACE_EVENTS_H_
 
+#include <algorithm>
 #include <cstdint>
-#include <deque>
+#include <new>
 #include <utility>
 
 namespace opencensus {
 namespace trace {
 
-// A fixed size FIFO queue of events of type T.  T must have a valid copy
-// constructor. TraceEvents is thread-compatible.
+// A fixed size FIFO queue of events of type T, kept in a ring buffer. No
+// memory is allocated until the first event is added; the buffer then grows
+// by doubling up to max_events, after which adding an event overwrites the
+// oldest one without allocating. T must be move constructible. TraceEvents is
+// thread-compatible.
 template <typename T>
 class TraceEvents final {
  public:
-  TraceEvents() : total_recorded_events_(0), max_events_(0) {}
-  explicit TraceEvents(uint32_t max_events)
-      : total_recorded_events_(0), max_events_(max_events) {}
+  TraceEvents() : TraceEvents(0) {}
+  explicit TraceEvents(uint32_t max_events) : max_events_(max_events) {}
+  ~TraceEvents();
+
+  TraceEvents(const TraceEvents&) = delete;
+  TraceEvents& operator=(const TraceEvents&) = delete;
 
   // Returns the number of the dropped events.
-  uint32_t num_events_dropped() const;
+  uint32_t num_events_dropped() const {
+    return total_recorded_events_ - taken_events_ - size_;
+  }
   // Returns the number of the recorded events. Including the events that were
   // dropped.
-  uint32_t num_events_recorded() const;
+  uint32_t num_events_recorded() const { return total_recorded_events_; }
+
+  // Returns the number of events currently in the queue.
+  uint32_t size() const { return size_; }
 
   // Adds an event to the event queue. If max_events_ is exceeded, an event
   // will be evicted in a FIFO manner.
-  void AddEvent(const T& event);
-  void AddEvent(T&& event);
+  void AddEvent(const T& event) { Emplace(event); }
+  void AddEvent(T&& event) { Emplace(std::move(event)); }
 
-  // Returns a vector of populate with all the events currently in the queue.
-  const std::deque<T>& events() const;
+  // Calls f(const T&), or f(T&), on every event in the queue, oldest first.
+  template <typename F>
+  void ForEach(F f) const;
+  template <typename F>
+  void ForEachMutable(F f);
+
+  // Calls f(T&&) on every event in the queue, oldest first, then empties the
+  // queue. Taken events still count as recorded, and not as dropped.
+  template <typename F>
+  void Take(F f);
 
  private:
-  uint32_t total_recorded_events_;
-  uint32_t max_events_;
-  std::deque<T> events_;
+  // The initial capacity of the buffer, if max_events_ allows.
+  static constexpr uint32_t kInitialCapacity = 8;
+
+  template <typename U>
+  void Emplace(U&& event);
+  // Grows the buffer, which must not be full with max_events_ events.
+  void Grow();
+  // Returns the i-th oldest event.
+  T* At(uint32_t i) const {
+    const uint32_t index = begin_ + i;
+    return events_ + (index < capacity_ ? index : index - capacity_);
+  }
+
+  uint32_t total_recorded_events_ = 0;
+  uint32_t taken_events_ = 0;
+  const uint32_t max_events_;
+  uint32_t capacity_ = 0;
+  // The index of the oldest event.
+  uint32_t begin_ = 0;
+  uint32_t size_ = 0;
+  T* events_ = nullptr;
 };
 
 template <typename T>
-inline uint32_t TraceEvents<T>::num_events_dropped() const {
-  return total_recorded_events_ - events_.size();
-}
+constexpr uint32_t TraceEvents<T>::kInitialCapacity;
 
 template <typename T>
-inline uint32_t TraceEvents<T>::num_events_recorded() const {
-  return num_events_recorded;
+TraceEvents<T>::~TraceEvents() {
+  for (uint32_t i = 0; i < size_; ++i) {
+    At(i)->~T();
+  }
+  ::operator delete(events_);
 }
 
 template <typename T>
-inline void TraceEvents<T>::AddEvent(const T& event) {
+template <typename U>
+void TraceEvents<T>::Emplace(U&& event) {
   // Blank span has 0 max events.
   if (max_events_ == 0) {
     return;
   }
 
-  if (events_.size() >= max_events_) {
-    events_.pop_front();
-  }
-  events_.emplace_back(event);
   total_recorded_events_++;
+  if (size_ == max_events_) {
+    // Overwrite the oldest event, which makes it the newest.
+    T* oldest = At(0);
+    oldest->~T();
+    new (oldest) T(std::forward<U>(event));
+    begin_ = begin_ + 1 == capacity_ ? 0 : begin_ + 1;
+    return;
+  }
+  if (size_ == capacity_) {
+    Grow();
+  }
+  new (At(size_)) T(std::forward<U>(event));
+  size_++;
 }
 
 template <typename T>
-inline void TraceEvents<T>::AddEvent(T&& event) {
-  // Blank span has 0 max events.
-  if (max_events_ == 0) {
-    return;
+void TraceEvents<T>::Grow() {
+  const uint32_t capacity =
+      capacity_ == 0
+          ? std::min(max_events_, kInitialCapacity)
+          : static_cast<uint32_t>(
+                std::min<uint64_t>(max_events_, uint64_t{capacity_} * 2));
+  T* events = static_cast<T*>(::operator new(sizeof(T) * capacity));
+  for (uint32_t i = 0; i < size_; ++i) {
+    T* event = At(i);
+    new (events + i) T(std::move(*event));
+    event->~T();
   }
+  ::operator delete(events_);
+  events_ = events;
+  capacity_ = capacity;
+  begin_ = 0;
+}
 
-  if (events_.size() >= max_events_) {
-    events_.pop_front();
+template <typename T>
+template <typename F>
+void TraceEvents<T>::ForEach(F f) const {
+  for (uint32_t i = 0; i < size_; ++i) {
+    f(static_cast<const T&>(*At(i)));
   }
-  events_.emplace_back(std::move(event));
-  total_recorded_events_++;
 }
 
 template <typename T>
-inline const std::deque<T>& TraceEvents<T>::events() const {
-  return events_;
+template <typename F>
+void TraceEvents<T>::ForEachMutable(F f) {
+  for (uint32_t i = 0; i < size_; ++i) {
+    f(*At(i));
+  }
+}
+
+template <typename T>
+template <typename F>
+void TraceEvents<T>::Take(F f) {
+  for (uint32_t i = 0; i < size_; ++i) {
+    T* event = At(i);
+    f(std::move(*event));
+    event->~T();
+  }
+  taken_events_ += size_;
+  begin_ = 0;
+  size_ = 0;
 }
 
 }  // namespace trace
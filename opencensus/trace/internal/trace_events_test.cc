@@ -0,0 +1,84 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opencensus/trace/internal/trace_events.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace opencensus {
+namespace trace {
+namespace {
+
+std::vector<std::string> Contents(const TraceEvents<std::string>& events) {
+  std::vector<std::string> contents;
+  events.ForEach(
+      [&contents](const std::string& event) { contents.push_back(event); });
+  return contents;
+}
+
+TEST(TraceEventsTest, BlankHasNoEvents) {
+  TraceEvents<std::string> events;
+  events.AddEvent("event");
+  EXPECT_EQ(0, events.size());
+  EXPECT_EQ(0, events.num_events_recorded());
+  EXPECT_EQ(0, events.num_events_dropped());
+}
+
+TEST(TraceEventsTest, EvictsOldestEvents) {
+  TraceEvents<std::string> events(20);
+  for (int i = 0; i < 50; ++i) {
+    events.AddEvent(std::to_string(i));
+    if (i == 9) {
+      EXPECT_EQ(std::vector<std::string>({"0", "1", "2", "3", "4", "5", "6",
+                                          "7", "8", "9"}),
+                Contents(events));
+    }
+  }
+  std::vector<std::string> expected;
+  for (int i = 30; i < 50; ++i) expected.push_back(std::to_string(i));
+  EXPECT_EQ(expected, Contents(events));
+  EXPECT_EQ(50, events.num_events_recorded());
+  EXPECT_EQ(30, events.num_events_dropped());
+}
+
+TEST(TraceEventsTest, ForEachMutable) {
+  TraceEvents<std::string> events(3);
+  for (int i = 0; i < 4; ++i) events.AddEvent(std::to_string(i));
+  events.ForEachMutable([](std::string& event) { event += "!"; });
+  EXPECT_EQ(std::vector<std::string>({"1!", "2!", "3!"}), Contents(events));
+}
+
+TEST(TraceEventsTest, TakeMovesEventsOut) {
+  TraceEvents<std::string> events(3);
+  for (int i = 0; i < 5; ++i) events.AddEvent(std::to_string(i));
+  std::vector<std::string> taken;
+  events.Take(
+      [&taken](std::string&& event) { taken.push_back(std::move(event)); });
+  EXPECT_EQ(std::vector<std::string>({"2", "3", "4"}), taken);
+  EXPECT_EQ(0, events.size());
+  EXPECT_EQ(5, events.num_events_recorded());
+  EXPECT_EQ(2, events.num_events_dropped());
+
+  events.AddEvent("5");
+  EXPECT_EQ(std::vector<std::string>({"5"}), Contents(events));
+  EXPECT_EQ(2, events.num_events_dropped());
+}
+
+}  // namespace
+}  // namespace trace
+}  // namespace opencensus
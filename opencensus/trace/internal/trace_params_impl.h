@@ -55,6 +55,11 @@ class TraceParamsImpl final {
                            std::memory_order_acquire))};
   }
 
+  // The threshold of the ProbabilitySampler, without building a TraceParams.
+  uint64_t probability_threshold() const {
+    return probability_threshold_.load(std::memory_order_acquire);
+  }
+
  private:
   std::atomic<uint32_t> max_attributes_;
   std::atomic<uint32_t> max_annotations_;
@@ -27,7 +27,8 @@ namespace opencensus {
 namespace trace {
 
 WithSpan::WithSpan(const Span& span, bool cond, bool end_span)
-    : swapped_span_(span)
+    : swapped_context_(cond ? Context::Current().WithReplacedSpan(span)
+                            : Context())
 #ifndef NDEBUG
       ,
       original_context_(Context::InternalMutableCurrent())
@@ -45,7 +46,7 @@ WithSpan::~WithSpan() {
          "constructed.");
 #endif
   if (cond_ && end_span_) {
-    Context::InternalMutableCurrent()->span_.End();
+    Context::InternalMutableCurrent()->span().End();
   }
   ConditionalSwap();
 }
@@ -53,7 +54,7 @@ WithSpan::~WithSpan() {
 void WithSpan::ConditionalSwap() {
   if (cond_) {
     using std::swap;
-    swap(Context::InternalMutableCurrent()->span_, swapped_span_);
+    swap(*Context::InternalMutableCurrent(), swapped_context_);
   }
 }
 
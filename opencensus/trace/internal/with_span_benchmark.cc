@@ -17,6 +17,8 @@
 #include <cstdlib>
 
 #include "benchmark/benchmark.h"
+#include "opencensus/context/context.h"
+#include "opencensus/context/with_context.h"
 #include "opencensus/trace/sampler.h"
 #include "opencensus/trace/span.h"
 
@@ -59,6 +61,19 @@ void BM_WithSpanConditionFalse(benchmark::State& state) {
 }
 BENCHMARK(BM_WithSpanConditionFalse);
 
+void BM_CaptureAndRestoreContextWithSpan(benchmark::State& state) {
+  static ::opencensus::trace::AlwaysSampler sampler;
+  auto span = Span::StartSpan("MySpan", /*parent=*/nullptr, {&sampler});
+  WithSpan ws(span);
+  for (auto _ : state) {
+    ::opencensus::context::Context ctx =
+        ::opencensus::context::Context::Current();
+    ::opencensus::context::WithContext wc(ctx);
+  }
+  span.End();
+}
+BENCHMARK(BM_CaptureAndRestoreContextWithSpan);
+
 }  // namespace
 }  // namespace trace
 }  // namespace opencensus
@@ -58,6 +58,17 @@ std::string ToB3TraceIdHeader(const SpanContext& ctx);
 // Returns a value for the X-B3-SpanId header.
 std::string ToB3SpanIdHeader(const SpanContext& ctx);
 
+// The lengths of the X-B3-TraceId and X-B3-SpanId values.
+constexpr int kB3TraceIdHeaderLen = 32;
+constexpr int kB3SpanIdHeaderLen = 16;
+
+// Fill pre-allocated buffers with the values for the X-B3-TraceId and
+// X-B3-SpanId headers, without allocating. The buffers must be at least
+// kB3TraceIdHeaderLen and kB3SpanIdHeaderLen bytes long respectively. No
+// terminating NUL is written.
+void ToB3TraceIdHeader(const SpanContext& ctx, char* out);
+void ToB3SpanIdHeader(const SpanContext& ctx, char* out);
+
 // Returns a value for the X-B3-Sampled header.
 std::string ToB3SampledHeader(const SpanContext& ctx);
 
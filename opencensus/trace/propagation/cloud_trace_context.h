@@ -46,6 +46,21 @@ SpanContext FromCloudTraceContextHeader(absl::string_view header);
 // Returns a value for the X-Cloud-Trace-Context header.
 std::string ToCloudTraceContextHeader(const SpanContext& ctx);
 
+// The maximum length of the X-Cloud-Trace-Context value:
+//     32 (trace_id)
+//   +  1 ("/")
+//   + 20 (span_id in decimal)
+//   +  4 (";o=1")
+//   ----
+//     57
+constexpr int kCloudTraceContextHeaderMaxLen = 57;
+
+// Fills a pre-allocated buffer with the value for the X-Cloud-Trace-Context
+// header, without allocating, and returns its length. The buffer must be at
+// least kCloudTraceContextHeaderMaxLen bytes long. No terminating NUL is
+// written.
+int ToCloudTraceContextHeader(const SpanContext& ctx, char* out);
+
 }  // namespace propagation
 }  // namespace trace
 }  // namespace opencensus
@@ -44,6 +44,14 @@ SpanContext FromTraceParentHeader(absl::string_view header);
 // Returns a value for the traceparent header.
 std::string ToTraceParentHeader(const SpanContext& ctx);
 
+// The length of the traceparent value: "00-" + 32 + "-" + 16 + "-" + 2.
+constexpr int kTraceParentHeaderLen = 55;
+
+// Fills a pre-allocated buffer with the value for the traceparent header,
+// without allocating. The buffer must be at least kTraceParentHeaderLen bytes
+// long. No terminating NUL is written.
+void ToTraceParentHeader(const SpanContext& ctx, char* out);
+
 }  // namespace propagation
 }  // namespace trace
 }  // namespace opencensus
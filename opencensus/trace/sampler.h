@@ -15,11 +15,13 @@
 #ifndef OPENCENSUS_TRACE_SAMPLER_H_
 #define OPENCENSUS_TRACE_SAMPLER_H_
 
+#include <atomic>
 #include <cstdint>
 #include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "opencensus/trace/span_context.h"
 #include "opencensus/trace/span_id.h"
 #include "opencensus/trace/trace_id.h"
@@ -65,6 +67,62 @@ class ProbabilitySampler final : public Sampler {
   const uint64_t threshold_;
 };
 
+// Samples at most max_per_second root spans per second, using a token bucket
+// that allows bursts of up to one second's worth of spans. Spans with a local
+// parent are not sampled: a child of a sampled parent is sampled without
+// consulting the Sampler. ShouldSample() is lock-free.
+class RateLimitingSampler final : public Sampler {
+ public:
+  explicit RateLimitingSampler(double max_per_second);
+
+  bool ShouldSample(const SpanContext* parent_context, bool has_remote_parent,
+                    const TraceId& trace_id, const SpanId& span_id,
+                    absl::string_view name,
+                    const std::vector<Span*>& parent_links) const override;
+
+ private:
+  // The time between samples at the maximum rate, or 0 to never sample.
+  const int64_t interval_nanos_;
+  const int64_t burst_nanos_;
+  // The time at which the bucket will be empty; tokens are available while it
+  // is in the past.
+  mutable std::atomic<int64_t> empty_time_nanos_;
+};
+
+// Samples root spans with a probability that is adjusted once per window, so
+// that about target_per_second spans are sampled per second whatever the
+// traffic. Within a window, at most twice the target number of spans are
+// sampled, which bounds the cost of a sudden spike until the next adjustment.
+// As with ProbabilitySampler, the decision is derived from the TraceId. Spans
+// with a local parent are not sampled. ShouldSample() is lock-free.
+class AdaptiveSampler final : public Sampler {
+ public:
+  explicit AdaptiveSampler(double target_per_second,
+                           absl::Duration window = absl::Seconds(1));
+
+  bool ShouldSample(const SpanContext* parent_context, bool has_remote_parent,
+                    const TraceId& trace_id, const SpanId& span_id,
+                    absl::string_view name,
+                    const std::vector<Span*>& parent_links) const override;
+
+  // Returns the current sampling probability.
+  double probability() const;
+
+ private:
+  // Starts a new window, if the current one has ended by now.
+  void MaybeAdjust(int64_t now_nanos) const;
+
+  const double target_per_window_;
+  const int64_t window_nanos_;
+  const uint64_t max_per_window_;
+  mutable std::atomic<int64_t> window_end_nanos_;
+  // Root spans seen and sampled in the current window.
+  mutable std::atomic<uint64_t> seen_;
+  mutable std::atomic<uint64_t> sampled_;
+  // The probability, converted to a value between [0, UINT64_MAX].
+  mutable std::atomic<uint64_t> threshold_;
+};
+
 // Always samples.
 class AlwaysSampler final : public Sampler {
  public:
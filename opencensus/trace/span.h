@@ -15,7 +15,7 @@
 #ifndef OPENCENSUS_TRACE_SPAN_H_
 #define OPENCENSUS_TRACE_SPAN_H_
 
-#include <memory>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -24,6 +24,7 @@
 #include "opencensus/trace/attribute_value_ref.h"
 #include "opencensus/trace/sampler.h"
 #include "opencensus/trace/span_context.h"
+#include "opencensus/trace/span_impl_ptr.h"
 #include "opencensus/trace/status_code.h"
 #include "opencensus/trace/trace_config.h"
 #include "opencensus/trace/trace_params.h"
@@ -36,7 +37,6 @@ class Context;
 namespace trace {
 
 namespace exporter {
-class LocalSpanStoreImpl;
 class RunningSpanStoreImpl;
 }  // namespace exporter
 
@@ -48,6 +48,8 @@ class SpanTestPeer;
 // AttributesRef is an initializer list of key-value pairs, used to pass
 // Attributes to the tracing API. e.g.:
 //   AddAttributes({{"key1", "value1"}, {"key2", 123}});
+// Keys and values are copied into the span, except for static strings: see
+// StaticString.
 using AttributesRef =
     absl::Span<const std::pair<absl::string_view, AttributeValueRef>>;
 
@@ -59,6 +61,9 @@ struct StartSpanOptions {
 
   // The Sampler to use. It must remain valid for the duration of the
   // StartSpan() call. If nullptr, use the default Sampler from TraceConfig.
+  // Children of sampled Spans are always sampled. Without a Sampler, children
+  // of local Spans that aren't sampled aren't sampled either, unless tail
+  // sampling is enabled or parent_links are given.
   //
   // A Span that's sampled will be exported (see exporter/span_exporter.h).
   // All sampled Spans record events.
@@ -86,6 +91,10 @@ struct StartSpanOptions {
 //
 // As an alternative to explicitly passing Span objects between functions,
 // consider using Context. (see the ../context/ directory).
+//
+// When built with OPENCENSUS_DISABLE_INSTRUMENTATION (see README.md), every
+// method is an inline no-op: a Span only carries its parent's SpanContext, so
+// that it still propagates, and nothing is ever recorded or exported.
 class Span final {
  public:
   // Constructs a no-op Span with an invalid context. Attempts to add
@@ -170,15 +179,16 @@ class Span final {
 
   // Returns true if the Span is recording events (will appear in Span stores).
   // Sampled spans always record events, but not all Spans that are recording
-  // are sampled.
+  // are sampled: with tail sampling, every Span records events, and unsampled
+  // Spans are exported only if their trace matches the TailSamplingPolicy.
   bool IsRecording() const;
 
  private:
   Span() = delete;
-  Span(const SpanContext& context, SpanImpl* impl);
+  Span(const SpanContext& context, SpanImplPtr impl);
 
   // Returns span_impl_, only used for testing.
-  std::shared_ptr<SpanImpl> span_impl_for_test() { return span_impl_; }
+  SpanImplPtr span_impl_for_test() { return span_impl_; }
 
   // Swaps contents, used for Context.
   friend void swap(Span& a, Span& b);
@@ -189,18 +199,68 @@ class Span final {
   SpanContext context_;
 
   // Shared pointer to the underlying Span representation. This is nullptr for
-  // Spans which are not recording events. This is an implementation detail, not
-  // part of the public API. We don't mark it const so that we can swap() Spans.
-  std::shared_ptr<SpanImpl> span_impl_;
+  // Spans which are not recording events. This is an implementation detail,
+  // not part of the public API. We don't mark it const so that we can swap()
+  // Spans.
+  SpanImplPtr span_impl_;
+
+  // Shared pointer to what span metrics (see span_metrics.h) track for a Span
+  // that isn't recording events. This is nullptr for Spans which are recording
+  // events, or while span metrics are disabled.
+  CountedSpanPtr counted_span_;
 
   friend class ::opencensus::context::Context;
   friend class ::opencensus::trace::exporter::RunningSpanStoreImpl;
-  friend class ::opencensus::trace::exporter::LocalSpanStoreImpl;
   friend class ::opencensus::trace::SpanTestPeer;
   friend class ::opencensus::trace::SpanGenerator;
   friend class ::opencensus::CensusContext;
 };
 
+#ifdef OPENCENSUS_DISABLE_INSTRUMENTATION
+
+inline Span Span::BlankSpan() { return Span(SpanContext(), nullptr); }
+
+inline Span Span::StartSpan(absl::string_view /*name*/, const Span* parent,
+                            const StartSpanOptions& /*options*/) {
+  return Span(parent == nullptr ? SpanContext() : parent->context_, nullptr);
+}
+
+inline Span Span::StartSpanWithRemoteParent(
+    absl::string_view /*name*/, const SpanContext& parent_ctx,
+    const StartSpanOptions& /*options*/) {
+  return Span(parent_ctx, nullptr);
+}
+
+inline Span::Span(const SpanContext& context, SpanImplPtr /*impl*/)
+    : context_(context) {}
+
+inline void Span::AddAttribute(absl::string_view /*key*/,
+                               AttributeValueRef /*attribute*/) const {}
+inline void Span::AddAttributes(AttributesRef /*attributes*/) const {}
+inline void Span::AddAnnotation(absl::string_view /*description*/,
+                                AttributesRef /*attributes*/) const {}
+inline void Span::AddSentMessageEvent(
+    uint32_t /*message_id*/, uint32_t /*compressed_message_size*/,
+    uint32_t /*uncompressed_message_size*/) const {}
+inline void Span::AddReceivedMessageEvent(
+    uint32_t /*message_id*/, uint32_t /*compressed_message_size*/,
+    uint32_t /*uncompressed_message_size*/) const {}
+inline void Span::AddParentLink(const SpanContext& /*parent_ctx*/,
+                                AttributesRef /*attributes*/) const {}
+inline void Span::AddChildLink(const SpanContext& /*child_ctx*/,
+                               AttributesRef /*attributes*/) const {}
+inline void Span::SetStatus(StatusCode /*canonical_code*/,
+                            absl::string_view /*message*/) const {}
+inline void Span::SetName(absl::string_view /*name*/) const {}
+inline void Span::End() const {}
+inline const SpanContext& Span::context() const { return context_; }
+inline bool Span::IsSampled() const {
+  return context_.trace_options().IsSampled();
+}
+inline bool Span::IsRecording() const { return false; }
+
+#endif  // OPENCENSUS_DISABLE_INSTRUMENTATION
+
 }  // namespace trace
 }  // namespace opencensus
 
@@ -0,0 +1,98 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef OPENCENSUS_TRACE_SPAN_IMPL_PTR_H_
+#define OPENCENSUS_TRACE_SPAN_IMPL_PTR_H_
+
+#include <cstddef>
+
+namespace opencensus {
+namespace trace {
+
+class CountedSpan;
+class SpanImpl;
+
+// Adds or drops a reference to a SpanImpl or CountedSpan. Dropping the last
+// reference returns the object to its pool. Defined in span_impl.cc and
+// span_counts.cc.
+void IntrusiveRef(SpanImpl* span);
+void IntrusiveUnref(SpanImpl* span);
+void IntrusiveRef(CountedSpan* span);
+void IntrusiveUnref(CountedSpan* span);
+
+// IntrusivePtr is a reference-counted pointer, like a std::shared_ptr, except
+// that the count is kept in the object itself, so that no separate control
+// block is allocated.
+//
+// This is not a public API, please refer to span.h. It is outside internal/
+// only because Span holds a SpanImplPtr and a CountedSpanPtr.
+template <typename T>
+class IntrusivePtr final {
+ public:
+  IntrusivePtr() = default;
+  IntrusivePtr(std::nullptr_t) {}
+
+  // Takes ownership of a reference that the caller already holds on ptr.
+  static IntrusivePtr Adopt(T* ptr) { return IntrusivePtr(ptr); }
+
+  IntrusivePtr(const IntrusivePtr& other) : ptr_(other.ptr_) {
+    if (ptr_ != nullptr) IntrusiveRef(ptr_);
+  }
+  IntrusivePtr(IntrusivePtr&& other) noexcept : ptr_(other.ptr_) {
+    other.ptr_ = nullptr;
+  }
+  IntrusivePtr& operator=(IntrusivePtr other) noexcept {
+    swap(*this, other);
+    return *this;
+  }
+  ~IntrusivePtr() {
+    if (ptr_ != nullptr) IntrusiveUnref(ptr_);
+  }
+
+  T* get() const { return ptr_; }
+  T* operator->() const { return ptr_; }
+  T& operator*() const { return *ptr_; }
+  explicit operator bool() const { return ptr_ != nullptr; }
+
+  friend bool operator==(const IntrusivePtr& a, std::nullptr_t) {
+    return a.ptr_ == nullptr;
+  }
+  friend bool operator!=(const IntrusivePtr& a, std::nullptr_t) {
+    return a.ptr_ != nullptr;
+  }
+
+  friend void swap(IntrusivePtr& a, IntrusivePtr& b) noexcept {
+    T* tmp = a.ptr_;
+    a.ptr_ = b.ptr_;
+    b.ptr_ = tmp;
+  }
+
+ private:
+  explicit IntrusivePtr(T* ptr) : ptr_(ptr) {}
+
+  T* ptr_ = nullptr;
+};
+
+// The underlying representation of a recording Span. See internal/span_impl.h.
+using SpanImplPtr = IntrusivePtr<SpanImpl>;
+
+// What span metrics track for a Span that isn't recording. See
+// internal/span_counts.h.
+using CountedSpanPtr = IntrusivePtr<CountedSpan>;
+
+}  // namespace trace
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_TRACE_SPAN_IMPL_PTR_H_
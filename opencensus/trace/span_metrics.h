@@ -0,0 +1,71 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_TRACE_SPAN_METRICS_H_
+#define OPENCENSUS_TRACE_SPAN_METRICS_H_
+
+#include "opencensus/stats/view_descriptor.h"
+
+namespace opencensus {
+namespace trace {
+
+// SpanMetrics records the rate, errors and duration of every span, sampled or
+// not, as stats, so that per-operation service metrics stay accurate however
+// low the trace sampling rate is.
+//
+// Ended spans are counted locally, by name and status, in the latency buckets
+// of the LocalSpanStore. The span exporter's worker records the new counts as
+// stats after each export, so metrics lag spans by up to one export interval.
+// Spans beyond the first 1024 names are counted under the name "(other)".
+//
+// Measures, tagged with "span_name" and "span_status" (the canonical code,
+// e.g. "OK" or "UNAVAILABLE"):
+//   opencensus.io/trace/span_count: the number of ended spans, also tagged
+//       with "span_latency", the latency bucket, e.g. "[10us, 100us)".
+//   opencensus.io/trace/span_errors: the number of ended spans whose status is
+//       not OK.
+//
+// This class is thread-safe.
+class SpanMetrics final {
+ public:
+  // Starts recording every span that ends. Calling this more than once has no
+  // effect.
+  static void Enable();
+
+  // Stops counting spans. Spans started before this may still be counted, and
+  // spans already counted are still recorded.
+  static void Disable();
+
+  // Enables recording and registers all views for export.
+  static void RegisterViewsForExport();
+
+  // The number of spans, by span_name and span_status.
+  static const stats::ViewDescriptor& SpanCountView();
+
+  // The number of spans whose status is not OK, by span_name.
+  static const stats::ViewDescriptor& SpanErrorCountView();
+
+  // The number of spans, by span_name, span_status and span_latency, whose
+  // values are the buckets of the LocalSpanStore: "[0, 10us)",
+  // "[10us, 100us)", ..., "[10s, 100s)", "[100s, inf)".
+  static const stats::ViewDescriptor& SpanLatencyView();
+
+ private:
+  SpanMetrics() = delete;
+};
+
+}  // namespace trace
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_TRACE_SPAN_METRICS_H_
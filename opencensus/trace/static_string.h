@@ -0,0 +1,73 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_TRACE_STATIC_STRING_H_
+#define OPENCENSUS_TRACE_STATIC_STRING_H_
+
+#include <cstddef>
+
+#include "absl/strings/string_view.h"
+
+namespace opencensus {
+namespace trace {
+
+// StaticString refers to a string that is never freed: a string literal, or a
+// string returned by Intern(). Spans record a StaticString by reference instead
+// of copying it. StaticString is trivially copyable and thread-safe.
+//
+// An attribute value passed as a StaticString is not copied. An attribute key,
+// or an annotation description, is not copied if it was interned:
+//   static const auto kMethodKey = StaticString::Intern("http.method");
+//   span.AddAttributes({{kMethodKey, StaticString::Literal("GET")}});
+class StaticString final {
+ public:
+  // Refers to a string literal. Only pass a literal: a char array that may be
+  // freed, e.g. a local buffer, would leave the span with a dangling reference.
+  // The string ends at the first NUL, so an array that is larger than its
+  // contents is not read past them.
+  template <size_t N>
+  static constexpr StaticString Literal(const char (&literal)[N]) {
+    return StaticString(FromView(),
+                        absl::string_view(literal, Length(literal, N - 1)));
+  }
+
+  // Returns a StaticString equal to s. The first time each distinct string is
+  // interned, it is copied into a process-wide table; later calls return the
+  // same copy. Interning takes a lock, so intern strings once, e.g. into a
+  // static variable, rather than on every use.
+  static StaticString Intern(absl::string_view s);
+
+  // Returns true if s points into the table used by Intern(). This is a
+  // constant-time check.
+  static bool IsInterned(absl::string_view s);
+
+  constexpr absl::string_view view() const { return value_; }
+  constexpr operator absl::string_view() const { return value_; }
+
+ private:
+  struct FromView {};
+  constexpr StaticString(FromView, absl::string_view value) : value_(value) {}
+
+  // Returns the length of s, up to its first NUL or max.
+  static constexpr size_t Length(const char* s, size_t max) {
+    return max == 0 || *s == '\0' ? 0 : 1 + Length(s + 1, max - 1);
+  }
+
+  absl::string_view value_;
+};
+
+}  // namespace trace
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_TRACE_STATIC_STRING_H_
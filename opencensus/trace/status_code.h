@@ -17,6 +17,8 @@
 
 #include <cstdint>
 
+#include "absl/strings/string_view.h"
+
 namespace opencensus {
 namespace trace {
 
@@ -177,6 +179,10 @@ enum StatusCode : uint8_t {
   DATA_LOSS = 15,
 };
 
+// Returns the name of a code, e.g. "UNAVAILABLE", or "" if it is not a known
+// code.
+absl::string_view StatusCodeToString(StatusCode code);
+
 }  // namespace trace
 }  // namespace opencensus
 
@@ -0,0 +1,54 @@
+// Copyright 2026, OpenCensus Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENCENSUS_TRACE_TAIL_SAMPLING_POLICY_H_
+#define OPENCENSUS_TRACE_TAIL_SAMPLING_POLICY_H_
+
+#include <cstddef>
+
+#include "absl/time/time.h"
+
+namespace opencensus {
+namespace trace {
+
+// TailSamplingPolicy decides which traces are exported when tail sampling is
+// enabled with TraceConfig::EnableTailSampling().
+//
+// With tail sampling, spans that are not sampled when they start are still
+// recorded. When they end they are buffered, per trace, until a local root
+// span of the trace (one without a parent in this process) ends. The buffered
+// spans are then exported if the trace matches the policy, and dropped
+// otherwise. Spans of a trace that end after that follow the same decision.
+// Sampled spans are exported as usual.
+struct TailSamplingPolicy {
+  // A trace is exported if one of its local root spans took at least this
+  // long.
+  absl::Duration min_latency = absl::InfiniteDuration();
+  // A trace is exported if any of its spans ended with a status other than OK.
+  bool errors = true;
+  // The fraction of the remaining traces that are exported. As with
+  // ProbabilitySampler, the decision is derived from the TraceId.
+  double probability = 0;
+
+  // At most this many traces are buffered. When a span of another trace ends,
+  // the oldest trace is dropped to make room.
+  size_t max_traces = 4096;
+  // At most this many spans are buffered per trace. Later spans are dropped.
+  size_t max_spans_per_trace = 256;
+};
+
+}  // namespace trace
+}  // namespace opencensus
+
+#endif  // OPENCENSUS_TRACE_TAIL_SAMPLING_POLICY_H_
@@ -15,6 +15,10 @@
 #ifndef OPENCENSUS_TRACE_TRACE_CONFIG_H_
 #define OPENCENSUS_TRACE_TRACE_CONFIG_H_
 
+#include <memory>
+
+#include "opencensus/trace/sampler.h"
+#include "opencensus/trace/tail_sampling_policy.h"
 #include "opencensus/trace/trace_params.h"
 
 namespace opencensus {
@@ -27,6 +31,27 @@ class TraceConfig {
   // Sets the currently active TraceParams. Doing this is not atomic: individual
   // parts of the active TraceParams are updated separately.
   static void SetCurrentTraceParams(const TraceParams& params);
+
+  // Sets the Sampler for spans that are started without a Sampler in their
+  // StartSpanOptions, in place of the ProbabilitySampler in TraceParams, e.g. a
+  // RateLimitingSampler or AdaptiveSampler. The change is atomic. Passing
+  // nullptr reverts to the ProbabilitySampler in TraceParams.
+  //
+  // Samplers that are replaced are kept alive until the process exits, since
+  // spans may still be starting with them, so this should not be called often.
+  static void SetSampler(std::unique_ptr<Sampler> sampler);
+
+  // Enables tail sampling, or replaces its policy: spans that are not sampled
+  // are recorded anyway, and exported only if their trace matches the policy.
+  // See tail_sampling_policy.h. Recording every span has a cost, so a low
+  // sampling probability should be combined with a selective policy.
+  //
+  // Policies that are replaced are kept alive until the process exits, since
+  // ending spans may still be reading them, so this should not be called often.
+  static void EnableTailSampling(const TailSamplingPolicy& policy);
+
+  // Disables tail sampling, dropping the spans it buffers.
+  static void DisableTailSampling();
 };
 
 }  // namespace trace
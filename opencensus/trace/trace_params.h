@@ -23,8 +23,8 @@ namespace opencensus {
 namespace trace {
 
 // TraceParams holds the limits for attributes, annotations, message_events,
-// links, and a ProbabilitySampler. For performance, only ProbabilitySampler is
-// supported as the globally active sampler.
+// links, and a ProbabilitySampler. Other global samplers can be set with
+// TraceConfig::SetSampler().
 //
 // The currently active TraceParams is set in TraceConfig.
 struct TraceParams final {
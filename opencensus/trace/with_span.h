@@ -53,7 +53,7 @@ class WithSpan {
 
   void ConditionalSwap();
 
-  Span swapped_span_;
+  ::opencensus::context::Context swapped_context_;
 #ifndef NDEBUG
   const ::opencensus::context::Context* original_context_;
 #endif